@@ -0,0 +1,1224 @@
+// Basic.c - Tiny Basic
+//
+// res/basic/tinytrek.bas を読み込んで命令に翻訳し、レジスタ型の仮想機械で実行する
+// Palo Alto Tiny BASIC と同じく、IF が偽なら行の残りを飛ばし、GOSUB の間は外の FOR を見せない
+//
+
+// 外部参照
+//
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Basic.h"
+
+// 内部関数
+//
+static void BasicCompileLine(struct BasicCompiler *compiler);
+static void BasicCompileStatement(struct BasicCompiler *compiler);
+static void BasicCompileLet(struct BasicCompiler *compiler);
+static void BasicCompileIf(struct BasicCompiler *compiler);
+static void BasicCompileGoto(struct BasicCompiler *compiler);
+static void BasicCompileGosub(struct BasicCompiler *compiler);
+static void BasicCompileReturn(struct BasicCompiler *compiler);
+static void BasicCompileRem(struct BasicCompiler *compiler);
+static void BasicCompileFor(struct BasicCompiler *compiler);
+static void BasicCompileNext(struct BasicCompiler *compiler);
+static void BasicCompileInput(struct BasicCompiler *compiler);
+static void BasicCompilePrint(struct BasicCompiler *compiler);
+static void BasicCompileStop(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileExpression(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileSum(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileTerm(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileFactor(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileArgument(struct BasicCompiler *compiler);
+static struct BasicOperand BasicCompileBinary(struct BasicCompiler *compiler, int op, struct BasicOperand left, struct BasicOperand right);
+static struct BasicOperand BasicCompileUnary(struct BasicCompiler *compiler, int op, struct BasicOperand operand);
+static void BasicCompileStore(struct BasicCompiler *compiler, int variable, struct BasicOperand operand);
+static int BasicCompileRegister(struct BasicCompiler *compiler, struct BasicOperand operand);
+static int BasicCompileVariable(struct BasicCompiler *compiler);
+static int BasicCompileString(struct BasicCompiler *compiler);
+static int BasicEmit(struct BasicCompiler *compiler, int op, int a, int b, int c, int value);
+static int BasicAllocate(struct BasicCompiler *compiler);
+static void BasicRelease(struct BasicCompiler *compiler, int a);
+static void BasicError(struct BasicCompiler *compiler, int error);
+static int BasicPeek(struct BasicCompiler *compiler);
+static bool BasicIsEndOfLine(int c);
+static bool BasicMatchKeyword(struct BasicCompiler *compiler, const char *keyword);
+static bool BasicLink(struct BasicProgram *program);
+static int BasicCompare(int op, int left, int right);
+static void BasicPrintString(struct BasicMachine *machine, const char *string);
+static void BasicPrintNumber(struct BasicMachine *machine, int value);
+
+// 内部変数
+//
+static const struct BasicStatement basicStatements[] = {
+    {"NEXT", BasicCompileNext, },
+    {"LET", BasicCompileLet, },
+    {"IF", BasicCompileIf, },
+    {"GOTO", BasicCompileGoto, },
+    {"GOSUB", BasicCompileGosub, },
+    {"RETURN", BasicCompileReturn, },
+    {"REM", BasicCompileRem, },
+    {"FOR", BasicCompileFor, },
+    {"INPUT", BasicCompileInput, },
+    {"PRINT", BasicCompilePrint, },
+    {"STOP", BasicCompileStop, },
+};
+static const char *basicRelations[] = {
+    ">=",
+    "#",
+    ">",
+    "=",
+    "<=",
+    "<",
+};
+static const int basicRelationOps[] = {
+    kBasicOpGe,
+    kBasicOpNe,
+    kBasicOpGt,
+    kBasicOpEq,
+    kBasicOpLe,
+    kBasicOpLt,
+};
+
+// A..Z は struct Basic に続けて並んでいる
+typedef char BasicVariableCheck[offsetof(struct Basic, Z) - offsetof(struct Basic, A) == (kBasicVariableSize - 1) * sizeof (int) ? 1 : -1];
+
+
+// BASIC のソースを翻訳する
+//
+bool BasicCompile(struct BasicProgram *program, const char *source, int length)
+{
+    // プログラムの初期化
+    program->codeSize = 0;
+    program->stringSize = 0;
+    for (int i = 0; i < kGameBasicLineSize; i++) {
+        program->indexes[i] = -1;
+    }
+    program->lineSize = 0;
+    program->error = kBasicErrorNull;
+    program->errorLine = 0;
+
+    // 翻訳の初期化
+    struct BasicCompiler compiler;
+    memset(&compiler, 0, sizeof (struct BasicCompiler));
+    compiler.program = program;
+    compiler.source = source;
+    compiler.length = length;
+    compiler.line = -1;
+
+    // 行の翻訳
+    while (compiler.error == kBasicErrorNull) {
+        int c = BasicPeek(&compiler);
+        if (compiler.position >= compiler.length) {
+            break;
+        } else if (c == '\n' || c == '\r') {
+            ++compiler.position;
+        } else {
+            BasicCompileLine(&compiler);
+        }
+    }
+
+    // 最後の行の後は止まる
+    BasicCompileStop(&compiler);
+
+    // 飛び先の解決
+    if (compiler.error == kBasicErrorNull && !BasicLink(program)) {
+        compiler.error = kBasicErrorHow;
+    }
+    if (compiler.error != kBasicErrorNull) {
+        program->error = compiler.error;
+        if (program->errorLine == 0) {
+            program->errorLine = compiler.line;
+        }
+        return false;
+    }
+    return true;
+}
+
+// 1 行を翻訳する
+//
+static void BasicCompileLine(struct BasicCompiler *compiler)
+{
+    struct BasicProgram *program = compiler->program;
+
+    // 行番号の取得
+    int number = 0;
+    int digits = 0;
+    for (int c = BasicPeek(compiler); c >= '0' && c <= '9' && number < kGameBasicLineSize; c = BasicPeek(compiler)) {
+        number = number * 10 + (c - '0');
+        ++compiler->position;
+        ++digits;
+    }
+    if (digits == 0 || number <= compiler->line) {
+        BasicError(compiler, kBasicErrorWhat);
+        return;
+    }
+    if (number >= kGameBasicLineSize || program->lineSize >= kGameBasicLineSize) {
+        BasicError(compiler, kBasicErrorSorry);
+        return;
+    }
+    compiler->line = number;
+    program->indexes[number] = (int16_t)program->codeSize;
+    program->lines[program->lineSize].number = (int16_t)number;
+    program->lines[program->lineSize].pc = (int16_t)program->codeSize;
+    ++program->lineSize;
+
+    // 文の翻訳
+    compiler->ifSize = 0;
+    while (compiler->error == kBasicErrorNull) {
+        BasicCompileStatement(compiler);
+        int c = BasicPeek(compiler);
+        if (c == ';') {
+            ++compiler->position;
+        } else if (BasicIsEndOfLine(c)) {
+            break;
+        } else {
+            BasicError(compiler, kBasicErrorWhat);
+        }
+    }
+
+    // IF が偽のときは次の行へ飛ぶ
+    for (int i = 0; i < compiler->ifSize; i++) {
+        program->codes[compiler->ifs[i]].value = program->codeSize;
+    }
+}
+
+// 文を翻訳する
+//
+static void BasicCompileStatement(struct BasicCompiler *compiler)
+{
+    // 一時レジスタは文ごとに使い直す
+    compiler->temporary = kBasicVariableSize;
+
+    // キーワードのない文は LET
+    for (int i = 0; i < (int)(sizeof (basicStatements) / sizeof (struct BasicStatement)); i++) {
+        if (BasicMatchKeyword(compiler, basicStatements[i].keyword)) {
+            (*basicStatements[i].function)(compiler);
+            return;
+        }
+    }
+    BasicCompileLet(compiler);
+}
+
+// LET: V=e[,V=e...] / @(e)=e
+//
+static void BasicCompileLet(struct BasicCompiler *compiler)
+{
+    while (compiler->error == kBasicErrorNull) {
+        compiler->temporary = kBasicVariableSize;
+        if (BasicPeek(compiler) == '@') {
+            ++compiler->position;
+            struct BasicOperand index = BasicCompileArgument(compiler);
+            if (BasicPeek(compiler) != '=') {
+                BasicError(compiler, kBasicErrorWhat);
+                return;
+            }
+            ++compiler->position;
+            int a = BasicCompileRegister(compiler, index);
+            int b = BasicCompileRegister(compiler, BasicCompileExpression(compiler));
+            BasicEmit(compiler, kBasicOpSetAt, a, b, 0, 0);
+        } else {
+            int variable = BasicCompileVariable(compiler);
+            if (BasicPeek(compiler) != '=') {
+                BasicError(compiler, kBasicErrorWhat);
+                return;
+            }
+            ++compiler->position;
+            BasicCompileStore(compiler, variable, BasicCompileExpression(compiler));
+        }
+        if (BasicPeek(compiler) != ',') {
+            break;
+        }
+        ++compiler->position;
+    }
+}
+
+// IF e 文
+//
+static void BasicCompileIf(struct BasicCompiler *compiler)
+{
+    struct BasicOperand condition = BasicCompileExpression(compiler);
+    if (compiler->error != kBasicErrorNull) {
+        return;
+    }
+
+    // 定数の条件は飛び越しを畳む
+    if (condition.constant) {
+        if (condition.value == 0) {
+            condition.value = BasicAllocate(compiler);
+            condition.constant = false;
+            BasicEmit(compiler, kBasicOpLoad, condition.value, 0, 0, 0);
+        } else {
+            BasicCompileStatement(compiler);
+            return;
+        }
+    }
+    if (compiler->ifSize >= kBasicIfSize) {
+        BasicError(compiler, kBasicErrorSorry);
+        return;
+    }
+    compiler->ifs[compiler->ifSize++] = BasicEmit(compiler, kBasicOpJumpZero, 0, condition.value, 0, 0);
+    BasicCompileStatement(compiler);
+}
+
+// GOTO e / GOSUB e
+//
+static void BasicCompileGoto(struct BasicCompiler *compiler)
+{
+    // 定数の飛び先は翻訳の後で命令の位置にする
+    struct BasicOperand target = BasicCompileExpression(compiler);
+    if (target.constant) {
+        BasicEmit(compiler, kBasicOpJump, 0, 0, 0, target.value);
+    } else {
+        BasicEmit(compiler, kBasicOpGoto, 0, target.value, 0, 0);
+    }
+}
+static void BasicCompileGosub(struct BasicCompiler *compiler)
+{
+    struct BasicOperand target = BasicCompileExpression(compiler);
+    if (target.constant) {
+        BasicEmit(compiler, kBasicOpGosub, 0, 0, 0, target.value);
+    } else {
+        BasicEmit(compiler, kBasicOpGosubTo, 0, target.value, 0, 0);
+    }
+}
+
+// RETURN
+//
+static void BasicCompileReturn(struct BasicCompiler *compiler)
+{
+    BasicEmit(compiler, kBasicOpReturn, 0, 0, 0, 0);
+}
+
+// REM
+//
+static void BasicCompileRem(struct BasicCompiler *compiler)
+{
+    while (compiler->position < compiler->length && !BasicIsEndOfLine(compiler->source[compiler->position])) {
+        ++compiler->position;
+    }
+}
+
+// FOR V=e TO e [STEP e]
+//
+static void BasicCompileFor(struct BasicCompiler *compiler)
+{
+    int variable = BasicCompileVariable(compiler);
+    if (BasicPeek(compiler) != '=') {
+        BasicError(compiler, kBasicErrorWhat);
+        return;
+    }
+    ++compiler->position;
+    BasicCompileStore(compiler, variable, BasicCompileExpression(compiler));
+    if (!BasicMatchKeyword(compiler, "TO")) {
+        BasicError(compiler, kBasicErrorWhat);
+        return;
+    }
+    int limit = BasicCompileRegister(compiler, BasicCompileExpression(compiler));
+    struct BasicOperand step = {true, 1, };
+    if (BasicMatchKeyword(compiler, "STEP")) {
+        step = BasicCompileExpression(compiler);
+    }
+    BasicEmit(compiler, kBasicOpFor, variable, limit, BasicCompileRegister(compiler, step), 0);
+}
+
+// NEXT V
+//
+static void BasicCompileNext(struct BasicCompiler *compiler)
+{
+    BasicEmit(compiler, kBasicOpNext, BasicCompileVariable(compiler), 0, 0, 0);
+}
+
+// INPUT ["s"]V[,...]
+//
+static void BasicCompileInput(struct BasicCompiler *compiler)
+{
+    while (compiler->error == kBasicErrorNull) {
+        int c = BasicPeek(compiler);
+
+        // 文字列は表示して、続く変数があればその問いにする
+        if (c == '"' || c == '\'') {
+            BasicEmit(compiler, kBasicOpPrintString, 0, 0, 0, BasicCompileString(compiler));
+            c = BasicPeek(compiler);
+            if (c >= 'A' && c <= 'Z') {
+                BasicEmit(compiler, kBasicOpInput, BasicCompileVariable(compiler), 0, 0, 0);
+            }
+
+        // 変数だけなら変数名を問いにする
+        } else if (c >= 'A' && c <= 'Z') {
+            char name[2] = {(char)c, '\0', };
+            struct BasicProgram *program = compiler->program;
+            if (program->stringSize + 2 > kBasicStringSize) {
+                BasicError(compiler, kBasicErrorSorry);
+                return;
+            }
+            memcpy(&program->strings[program->stringSize], name, 2);
+            BasicEmit(compiler, kBasicOpPrintString, 0, 0, 0, program->stringSize);
+            program->stringSize += 2;
+            BasicEmit(compiler, kBasicOpInput, BasicCompileVariable(compiler), 0, 0, 0);
+        } else {
+            BasicError(compiler, kBasicErrorWhat);
+        }
+        if (BasicPeek(compiler) != ',') {
+            break;
+        }
+        ++compiler->position;
+    }
+}
+
+// PRINT [#e,]["s",]e[,...][,]
+//
+static void BasicCompilePrint(struct BasicCompiler *compiler)
+{
+    bool newLine = true;
+    bool width = false;
+    for (int c = BasicPeek(compiler); c != ';' && !BasicIsEndOfLine(c) && compiler->error == kBasicErrorNull; ) {
+        compiler->temporary = kBasicVariableSize;
+        newLine = true;
+
+        // 文字列
+        if (c == '"' || c == '\'') {
+            BasicEmit(compiler, kBasicOpPrintString, 0, 0, 0, BasicCompileString(compiler));
+
+        // 桁数
+        } else if (c == '#') {
+            ++compiler->position;
+            struct BasicOperand operand = BasicCompileExpression(compiler);
+            if (operand.constant) {
+                BasicEmit(compiler, kBasicOpWidthK, 0, 0, 0, operand.value);
+            } else {
+                BasicEmit(compiler, kBasicOpWidth, 0, operand.value, 0, 0);
+            }
+            width = true;
+
+        // 数値（桁数は PR. ごとに 6 へ戻る）
+        } else {
+            if (!width) {
+                BasicEmit(compiler, kBasicOpWidthK, 0, 0, 0, kBasicWidthDefault);
+                width = true;
+            }
+            BasicEmit(compiler, kBasicOpPrintNumber, 0, BasicCompileRegister(compiler, BasicCompileExpression(compiler)), 0, 0);
+        }
+
+        // , が続けば改行しない
+        c = BasicPeek(compiler);
+        if (c != ',') {
+            break;
+        }
+        ++compiler->position;
+        newLine = false;
+        c = BasicPeek(compiler);
+    }
+    if (newLine) {
+        BasicEmit(compiler, kBasicOpPrintNewLine, 0, 0, 0, 0);
+    }
+    BasicEmit(compiler, kBasicOpFlush, 0, 0, 0, 0);
+}
+
+// STOP
+//
+static void BasicCompileStop(struct BasicCompiler *compiler)
+{
+    BasicEmit(compiler, kBasicOpStop, 0, 0, 0, 0);
+}
+
+// 式を翻訳する（関係演算子は 1 つまで）
+//
+static struct BasicOperand BasicCompileExpression(struct BasicCompiler *compiler)
+{
+    struct BasicOperand left = BasicCompileSum(compiler);
+    for (int i = 0; i < (int)(sizeof (basicRelations) / sizeof (const char *)); i++) {
+        if (BasicMatchKeyword(compiler, basicRelations[i])) {
+            struct BasicOperand right = BasicCompileSum(compiler);
+            return BasicCompileBinary(compiler, basicRelationOps[i], left, right);
+        }
+    }
+    return left;
+}
+static struct BasicOperand BasicCompileSum(struct BasicCompiler *compiler)
+{
+    struct BasicOperand left;
+    int c = BasicPeek(compiler);
+    if (c == '-') {
+        ++compiler->position;
+        left = BasicCompileUnary(compiler, kBasicOpNeg, BasicCompileTerm(compiler));
+    } else {
+        if (c == '+') {
+            ++compiler->position;
+        }
+        left = BasicCompileTerm(compiler);
+    }
+    for (c = BasicPeek(compiler); (c == '+' || c == '-') && compiler->error == kBasicErrorNull; c = BasicPeek(compiler)) {
+        ++compiler->position;
+        left = BasicCompileBinary(compiler, c == '+' ? kBasicOpAdd : kBasicOpSub, left, BasicCompileTerm(compiler));
+    }
+    return left;
+}
+static struct BasicOperand BasicCompileTerm(struct BasicCompiler *compiler)
+{
+    struct BasicOperand left = BasicCompileFactor(compiler);
+    for (int c = BasicPeek(compiler); (c == '*' || c == '/') && compiler->error == kBasicErrorNull; c = BasicPeek(compiler)) {
+        ++compiler->position;
+        left = BasicCompileBinary(compiler, c == '*' ? kBasicOpMul : kBasicOpDiv, left, BasicCompileFactor(compiler));
+    }
+    return left;
+}
+static struct BasicOperand BasicCompileFactor(struct BasicCompiler *compiler)
+{
+    struct BasicOperand operand = {true, 0, };
+    int c = BasicPeek(compiler);
+
+    // 関数
+    if (BasicMatchKeyword(compiler, "RND")) {
+        operand = BasicCompileUnary(compiler, kBasicOpRandom, BasicCompileArgument(compiler));
+    } else if (BasicMatchKeyword(compiler, "ABS")) {
+        operand = BasicCompileUnary(compiler, kBasicOpAbs, BasicCompileArgument(compiler));
+    } else if (BasicMatchKeyword(compiler, "SIZE")) {
+        operand.constant = false;
+        operand.value = BasicAllocate(compiler);
+        BasicEmit(compiler, kBasicOpSize, operand.value, 0, 0, 0);
+
+    // 配列
+    } else if (c == '@') {
+        ++compiler->position;
+        operand = BasicCompileUnary(compiler, kBasicOpGetAt, BasicCompileArgument(compiler));
+
+    // 変数はそのままレジスタになる
+    } else if (c >= 'A' && c <= 'Z') {
+        operand.constant = false;
+        operand.value = BasicCompileVariable(compiler);
+
+    // 数値
+    } else if (c >= '0' && c <= '9') {
+        int value = 0;
+        for (; c >= '0' && c <= '9'; c = BasicPeek(compiler)) {
+            value = value * 10 + (c - '0');
+            ++compiler->position;
+            if (value > 32767) {
+                BasicError(compiler, kBasicErrorHow);
+            }
+        }
+        operand.value = value;
+
+    // 括弧
+    } else if (c == '(') {
+        operand = BasicCompileArgument(compiler);
+    } else {
+        BasicError(compiler, kBasicErrorWhat);
+    }
+    return operand;
+}
+static struct BasicOperand BasicCompileArgument(struct BasicCompiler *compiler)
+{
+    struct BasicOperand operand = {true, 0, };
+    if (BasicPeek(compiler) != '(') {
+        BasicError(compiler, kBasicErrorWhat);
+        return operand;
+    }
+    ++compiler->position;
+    operand = BasicCompileExpression(compiler);
+    if (BasicPeek(compiler) != ')') {
+        BasicError(compiler, kBasicErrorWhat);
+        return operand;
+    }
+    ++compiler->position;
+    return operand;
+}
+
+// 2 項の演算を翻訳する
+//
+static struct BasicOperand BasicCompileBinary(struct BasicCompiler *compiler, int op, struct BasicOperand left, struct BasicOperand right)
+{
+    struct BasicOperand result = {true, 0, };
+    if (compiler->error != kBasicErrorNull) {
+        return result;
+    }
+
+    // 定数どうしは畳む
+    if (left.constant && right.constant) {
+        if (op == kBasicOpAdd) {
+            result.value = left.value + right.value;
+        } else if (op == kBasicOpSub) {
+            result.value = left.value - right.value;
+        } else if (op == kBasicOpMul) {
+            result.value = left.value * right.value;
+        } else if (op == kBasicOpDiv) {
+            if (right.value == 0) {
+                BasicError(compiler, kBasicErrorHow);
+            } else {
+                result.value = left.value / right.value;
+            }
+        } else {
+            result.value = BasicCompare(op, left.value, right.value);
+        }
+        return result;
+    }
+
+    // 左の定数は入れ替えるか、レジスタに載せる
+    if (left.constant) {
+        if (op == kBasicOpAdd || op == kBasicOpMul || op == kBasicOpEq || op == kBasicOpNe) {
+            struct BasicOperand swap = left;
+            left = right;
+            right = swap;
+        } else if (op == kBasicOpLt || op == kBasicOpGt || op == kBasicOpLe || op == kBasicOpGe) {
+            static const int mirrors[] = {kBasicOpGt, kBasicOpLt, kBasicOpGe, kBasicOpLe, };
+            struct BasicOperand swap = left;
+            left = right;
+            right = swap;
+            op = mirrors[op - kBasicOpLt];
+        } else {
+            int a = BasicAllocate(compiler);
+            BasicEmit(compiler, kBasicOpLoad, a, 0, 0, left.value);
+            left.constant = false;
+            left.value = a;
+        }
+    }
+
+    // 結果は左右の一時レジスタを使い回す
+    if (!right.constant) {
+        BasicRelease(compiler, right.value);
+    }
+    BasicRelease(compiler, left.value);
+    result.constant = false;
+    result.value = BasicAllocate(compiler);
+
+    // 右の定数は即値にする
+    if (right.constant) {
+        if (op == kBasicOpSub) {
+            BasicEmit(compiler, kBasicOpAddK, result.value, left.value, 0, -right.value);
+        } else if (op == kBasicOpDiv && right.value == 0) {
+            BasicError(compiler, kBasicErrorHow);
+        } else {
+            static const int immediates[] = {
+                kBasicOpAddK, -1, kBasicOpMulK, kBasicOpDivK,
+                kBasicOpEqK, kBasicOpNeK, kBasicOpLtK, kBasicOpGtK, kBasicOpLeK, kBasicOpGeK,
+            };
+            BasicEmit(compiler, immediates[op - kBasicOpAdd], result.value, left.value, 0, right.value);
+        }
+    } else {
+        BasicEmit(compiler, op, result.value, left.value, right.value, 0);
+    }
+    return result;
+}
+
+// 1 項の演算を翻訳する
+//
+static struct BasicOperand BasicCompileUnary(struct BasicCompiler *compiler, int op, struct BasicOperand operand)
+{
+    struct BasicOperand result = {true, 0, };
+    if (compiler->error != kBasicErrorNull) {
+        return result;
+    }
+
+    // 符号と絶対値の定数は畳む
+    if (operand.constant && op == kBasicOpNeg) {
+        result.value = -operand.value;
+        return result;
+    } else if (operand.constant && op == kBasicOpAbs) {
+        result.value = abs(operand.value);
+        return result;
+    }
+    int b = BasicCompileRegister(compiler, operand);
+    BasicRelease(compiler, b);
+    result.constant = false;
+    result.value = BasicAllocate(compiler);
+    BasicEmit(compiler, op, result.value, b, 0, 0);
+    return result;
+}
+
+// 変数に代入する
+//
+static void BasicCompileStore(struct BasicCompiler *compiler, int variable, struct BasicOperand operand)
+{
+    struct BasicProgram *program = compiler->program;
+    if (compiler->error != kBasicErrorNull) {
+        return;
+    }
+
+    // 定数は即値で入れる
+    if (operand.constant) {
+        BasicEmit(compiler, kBasicOpLoad, variable, 0, 0, operand.value);
+
+    // 直前の命令の結果なら書き込み先を変数にする
+    } else if (operand.value >= kBasicVariableSize && program->codeSize > 0 && program->codes[program->codeSize - 1].a == operand.value) {
+        program->codes[program->codeSize - 1].a = (uint8_t)variable;
+    } else if (operand.value != variable) {
+        BasicEmit(compiler, kBasicOpMove, variable, operand.value, 0, 0);
+    }
+}
+
+// 値をレジスタに載せる
+//
+static int BasicCompileRegister(struct BasicCompiler *compiler, struct BasicOperand operand)
+{
+    if (!operand.constant) {
+        return operand.value;
+    }
+    int a = BasicAllocate(compiler);
+    BasicEmit(compiler, kBasicOpLoad, a, 0, 0, operand.value);
+    return a;
+}
+
+// 変数を翻訳する
+//
+static int BasicCompileVariable(struct BasicCompiler *compiler)
+{
+    int c = BasicPeek(compiler);
+    if (c < 'A' || c > 'Z') {
+        BasicError(compiler, kBasicErrorWhat);
+        return 0;
+    }
+    ++compiler->position;
+    return c - 'A';
+}
+
+// 文字列を翻訳する（閉じる引用符がなければ行の終わりまで）
+//
+static int BasicCompileString(struct BasicCompiler *compiler)
+{
+    struct BasicProgram *program = compiler->program;
+    int quote = BasicPeek(compiler);
+    int offset = program->stringSize;
+    ++compiler->position;
+    while (compiler->position < compiler->length) {
+        int c = compiler->source[compiler->position];
+        if (BasicIsEndOfLine(c)) {
+            break;
+        }
+        ++compiler->position;
+        if (c == quote) {
+            break;
+        }
+        if (program->stringSize >= kBasicStringSize - 1) {
+            BasicError(compiler, kBasicErrorSorry);
+            return 0;
+        }
+        program->strings[program->stringSize++] = (char)c;
+    }
+    program->strings[program->stringSize++] = '\0';
+    return offset;
+}
+
+// 命令を追加する
+//
+static int BasicEmit(struct BasicCompiler *compiler, int op, int a, int b, int c, int value)
+{
+    struct BasicProgram *program = compiler->program;
+    if (program->codeSize >= kBasicCodeSize) {
+        BasicError(compiler, kBasicErrorSorry);
+        return 0;
+    }
+    struct BasicCode *code = &program->codes[program->codeSize];
+    code->op = (uint8_t)op;
+    code->a = (uint8_t)a;
+    code->b = (uint8_t)b;
+    code->c = (uint8_t)c;
+    code->value = value;
+    return program->codeSize++;
+}
+
+// 一時レジスタを確保する
+//
+static int BasicAllocate(struct BasicCompiler *compiler)
+{
+    if (compiler->temporary >= kBasicRegisterSize) {
+        BasicError(compiler, kBasicErrorSorry);
+        return kBasicRegisterSize - 1;
+    }
+    return compiler->temporary++;
+}
+
+// 一時レジスタを返す（確保した順に積んでいるので、その上ごと返す）
+//
+static void BasicRelease(struct BasicCompiler *compiler, int a)
+{
+    if (a >= kBasicVariableSize && a < compiler->temporary) {
+        compiler->temporary = a;
+    }
+}
+
+// 翻訳のエラーを記録する
+//
+static void BasicError(struct BasicCompiler *compiler, int error)
+{
+    if (compiler->error == kBasicErrorNull) {
+        compiler->error = error;
+        compiler->program->errorLine = compiler->line;
+    }
+}
+
+// 空白を飛ばして次の文字を取得する
+//
+static int BasicPeek(struct BasicCompiler *compiler)
+{
+    while (compiler->position < compiler->length && (compiler->source[compiler->position] == ' ' || compiler->source[compiler->position] == '\t')) {
+        ++compiler->position;
+    }
+    return compiler->position < compiler->length ? compiler->source[compiler->position] : '\n';
+}
+
+// 行の終わりかどうかを判定する
+//
+static bool BasicIsEndOfLine(int c)
+{
+    return c == '\n' || c == '\r' || c == '\0';
+}
+
+// キーワードを照合する（. で後ろを省略できる）
+//
+static bool BasicMatchKeyword(struct BasicCompiler *compiler, const char *keyword)
+{
+    int position = compiler->position;
+    for (int i = 0; keyword[i] != '\0'; i++) {
+        int c = BasicPeek(compiler);
+        if (c == keyword[i]) {
+            ++compiler->position;
+        } else if (c == '.' && i > 0) {
+            ++compiler->position;
+            return true;
+        } else {
+            compiler->position = position;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 定数の飛び先を行番号から命令の位置にする
+//
+static bool BasicLink(struct BasicProgram *program)
+{
+    for (int i = 0; i < program->codeSize; i++) {
+        struct BasicCode *code = &program->codes[i];
+        if (code->op == kBasicOpJump || code->op == kBasicOpGosub) {
+            int line = code->value;
+            if (line < 0 || line >= kGameBasicLineSize || program->indexes[line] < 0) {
+                program->errorLine = BasicFindLine(program, i);
+                return false;
+            }
+            code->value = program->indexes[line];
+        }
+    }
+    return true;
+}
+
+// 比較する
+//
+static int BasicCompare(int op, int left, int right)
+{
+    int result = 0;
+    if (op == kBasicOpEq) {
+        result = left == right;
+    } else if (op == kBasicOpNe) {
+        result = left != right;
+    } else if (op == kBasicOpLt) {
+        result = left < right;
+    } else if (op == kBasicOpGt) {
+        result = left > right;
+    } else if (op == kBasicOpLe) {
+        result = left <= right;
+    } else if (op == kBasicOpGe) {
+        result = left >= right;
+    }
+    return result;
+}
+
+// 仮想機械を開始する
+//
+void BasicStart(struct BasicMachine *machine, const struct BasicProgram *program, struct Basic *basic, BasicRandom random, void *userdata)
+{
+    memset(machine, 0, sizeof (struct BasicMachine));
+    machine->program = program;
+    machine->width = kBasicWidthDefault;
+    machine->input = -1;
+    machine->random = random;
+    machine->userdata = userdata;
+    basic->run.line = program->lineSize > 0 ? program->lines[0].number : 0;
+    basic->run.sentence = 0;
+    basic->returnStack = 0;
+}
+
+// 仮想機械を実行する
+// PR. の出力が溜まるか、IN. で入力を待つか、steps 命令を実行すると戻る
+//
+int BasicRun(struct BasicMachine *machine, struct Basic *basic, int steps)
+{
+    const struct BasicCode *codes = machine->program->codes;
+    int *r = machine->registers;
+    int pc = basic->run.sentence;
+    int at = pc;
+    int result = kBasicResultStep;
+    bool running = true;
+
+    // 出力は呼び出し側が受け取った
+    machine->textLength = 0;
+    machine->text[0] = '\0';
+
+    // 変数をレジスタに載せる
+    memcpy(r, &basic->A, sizeof (int) * kBasicVariableSize);
+
+    // 命令の実行
+    while (running && steps-- > 0) {
+        const struct BasicCode *code = &codes[pc];
+        at = pc++;
+        switch (code->op) {
+        case kBasicOpLoad:
+            r[code->a] = code->value;
+            break;
+        case kBasicOpMove:
+            r[code->a] = r[code->b];
+            break;
+        case kBasicOpNeg:
+            r[code->a] = -r[code->b];
+            break;
+        case kBasicOpAdd:
+            r[code->a] = r[code->b] + r[code->c];
+            break;
+        case kBasicOpSub:
+            r[code->a] = r[code->b] - r[code->c];
+            break;
+        case kBasicOpMul:
+            r[code->a] = r[code->b] * r[code->c];
+            break;
+        case kBasicOpDiv:
+            if (r[code->c] == 0) {
+                machine->error = kBasicErrorHow;
+                running = false;
+            } else {
+                r[code->a] = r[code->b] / r[code->c];
+            }
+            break;
+        case kBasicOpEq:
+            r[code->a] = r[code->b] == r[code->c];
+            break;
+        case kBasicOpNe:
+            r[code->a] = r[code->b] != r[code->c];
+            break;
+        case kBasicOpLt:
+            r[code->a] = r[code->b] < r[code->c];
+            break;
+        case kBasicOpGt:
+            r[code->a] = r[code->b] > r[code->c];
+            break;
+        case kBasicOpLe:
+            r[code->a] = r[code->b] <= r[code->c];
+            break;
+        case kBasicOpGe:
+            r[code->a] = r[code->b] >= r[code->c];
+            break;
+        case kBasicOpAddK:
+            r[code->a] = r[code->b] + code->value;
+            break;
+        case kBasicOpMulK:
+            r[code->a] = r[code->b] * code->value;
+            break;
+        case kBasicOpDivK:
+            r[code->a] = r[code->b] / code->value;
+            break;
+        case kBasicOpEqK:
+            r[code->a] = r[code->b] == code->value;
+            break;
+        case kBasicOpNeK:
+            r[code->a] = r[code->b] != code->value;
+            break;
+        case kBasicOpLtK:
+            r[code->a] = r[code->b] < code->value;
+            break;
+        case kBasicOpGtK:
+            r[code->a] = r[code->b] > code->value;
+            break;
+        case kBasicOpLeK:
+            r[code->a] = r[code->b] <= code->value;
+            break;
+        case kBasicOpGeK:
+            r[code->a] = r[code->b] >= code->value;
+            break;
+        case kBasicOpGetAt:
+            if ((unsigned int)r[code->b] >= kGameBasicArraySize) {
+                machine->error = kBasicErrorHow;
+                running = false;
+            } else {
+                r[code->a] = BasicGetAt(basic, r[code->b]);
+            }
+            break;
+        case kBasicOpSetAt:
+            if ((unsigned int)r[code->a] >= kGameBasicArraySize) {
+                machine->error = kBasicErrorHow;
+                running = false;
+            } else {
+                BasicSetAt(basic, r[code->a], r[code->b]);
+            }
+            break;
+        case kBasicOpRandom:
+            r[code->a] = (*machine->random)(machine->userdata, r[code->b]);
+            break;
+        case kBasicOpAbs:
+            r[code->a] = abs(r[code->b]);
+            break;
+        case kBasicOpSize:
+            r[code->a] = kGameBasicArraySize * 2;
+            break;
+        case kBasicOpJump:
+            pc = code->value;
+            break;
+        case kBasicOpJumpZero:
+            if (r[code->b] == 0) {
+                pc = code->value;
+            }
+            break;
+        case kBasicOpGoto:
+        case kBasicOpGosubTo:
+        case kBasicOpGosub:
+            {
+                // 計算で決まる飛び先は行の索引から引く
+                int target = code->value;
+                if (code->op != kBasicOpGosub) {
+                    int line = r[code->b];
+                    target = line >= 0 && line < kGameBasicLineSize ? machine->program->indexes[line] : -1;
+                    if (target < 0) {
+                        machine->error = kBasicErrorHow;
+                        running = false;
+                        break;
+                    }
+                }
+                if (code->op != kBasicOpGoto) {
+                    if (basic->returnStack >= kGameBasicReturnSize) {
+                        machine->error = kBasicErrorSorry;
+                        running = false;
+                        break;
+                    }
+                    basic->returns[basic->returnStack].line = BasicFindLine(machine->program, at);
+                    basic->returns[basic->returnStack].sentence = pc;
+                    machine->loopBases[basic->returnStack] = machine->loopBase;
+                    machine->loopBase = machine->loopSize;
+                    ++basic->returnStack;
+                }
+                pc = target;
+            }
+            break;
+        case kBasicOpReturn:
+            if (basic->returnStack <= 0) {
+                machine->error = kBasicErrorWhat;
+                running = false;
+            } else {
+                --basic->returnStack;
+                pc = basic->returns[basic->returnStack].sentence;
+                machine->loopSize = machine->loopBase;
+                machine->loopBase = machine->loopBases[basic->returnStack];
+            }
+            break;
+        case kBasicOpFor:
+            {
+                // 同じ変数の FOR は外す
+                int i = machine->loopBase;
+                while (i < machine->loopSize && machine->loops[i].variable != code->a) {
+                    ++i;
+                }
+                if (i < machine->loopSize) {
+                    memmove(&machine->loops[i], &machine->loops[i + 1], sizeof (struct BasicLoop) * (machine->loopSize - i - 1));
+                    --machine->loopSize;
+                }
+                if (machine->loopSize >= kBasicLoopSize) {
+                    machine->error = kBasicErrorSorry;
+                    running = false;
+                    break;
+                }
+                struct BasicLoop *loop = &machine->loops[machine->loopSize++];
+                loop->variable = code->a;
+                loop->limit = r[code->b];
+                loop->step = r[code->c];
+                loop->pc = pc;
+            }
+            break;
+        case kBasicOpNext:
+            {
+                // 内側の FOR は抜ける
+                int i = machine->loopSize - 1;
+                while (i >= machine->loopBase && machine->loops[i].variable != code->a) {
+                    --i;
+                }
+                if (i < machine->loopBase) {
+                    machine->error = kBasicErrorWhat;
+                    running = false;
+                    break;
+                }
+                struct BasicLoop *loop = &machine->loops[i];
+                int value = r[code->a] + loop->step;
+                r[code->a] = value;
+                if (loop->step >= 0 ? value > loop->limit : value < loop->limit) {
+                    machine->loopSize = i;
+                } else {
+                    machine->loopSize = i + 1;
+                    pc = loop->pc;
+                }
+            }
+            break;
+        case kBasicOpWidth:
+            machine->width = r[code->b];
+            break;
+        case kBasicOpWidthK:
+            machine->width = code->value;
+            break;
+        case kBasicOpPrintString:
+            BasicPrintString(machine, &machine->program->strings[code->value]);
+            break;
+        case kBasicOpPrintNumber:
+            BasicPrintNumber(machine, r[code->b]);
+            break;
+        case kBasicOpPrintNewLine:
+            BasicPrintString(machine, "\n");
+            break;
+        case kBasicOpFlush:
+            if (machine->textLength >= kBasicTextFlush) {
+                result = kBasicResultPrint;
+                running = false;
+            }
+            break;
+        case kBasicOpInput:
+            BasicPrintString(machine, ":");
+            machine->input = code->a;
+            result = kBasicResultInput;
+            running = false;
+            break;
+        case kBasicOpStop:
+            pc = at;
+            result = kBasicResultStop;
+            running = false;
+            break;
+        default:
+            machine->error = kBasicErrorWhat;
+            running = false;
+            break;
+        }
+    }
+
+    // エラーは止まった命令に留まる
+    if (machine->error != kBasicErrorNull) {
+        pc = at;
+        result = kBasicResultError;
+    }
+
+    // 変数を書き戻す
+    memcpy(&basic->A, r, sizeof (int) * kBasicVariableSize);
+    basic->run.line = BasicFindLine(machine->program, at);
+    basic->run.sentence = pc;
+    return result;
+}
+
+// 命令の位置の行番号を取得する
+//
+int BasicFindLine(const struct BasicProgram *program, int pc)
+{
+    int low = 0;
+    int high = program->lineSize - 1;
+    int number = 0;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (program->lines[middle].pc <= pc) {
+            number = program->lines[middle].number;
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return number;
+}
+
+// 変数を参照する
+//
+int BasicGetVariable(const struct Basic *basic, int index)
+{
+    return index >= 0 && index < kBasicVariableSize ? (&basic->A)[index] : 0;
+}
+void BasicSetVariable(struct Basic *basic, int index, int value)
+{
+    if (index >= 0 && index < kBasicVariableSize) {
+        (&basic->A)[index] = value;
+    }
+}
+
+// 配列を参照する
+//
+int BasicGetAt(const struct Basic *basic, int index)
+{
+    int value = 0;
+    if (index < kGameBasicArrayGalaxy) {
+        ;
+    } else if (index < kGameBasicArrayDamage) {
+        value = basic->galaxy[index - kGameBasicArrayGalaxy];
+    } else if (index < kGameBasicArraySector) {
+        value = basic->damage[index - kGameBasicArrayDamage];
+    } else if (index < kGameBasicArrayKlingonEnergy) {
+        int cell = index - kGameBasicArraySector;
+        value = (basic->sector[cell >> 1] >> ((cell & 1) * 4)) & 0x0f;
+    } else if (index < kGameBasicArrayKlingonX) {
+        value = basic->klingonEnergy[index - kGameBasicArrayKlingonEnergy];
+    } else if (index < kGameBasicArrayKlingonY) {
+        value = basic->klingonX[index - kGameBasicArrayKlingonX];
+    } else if (index < kGameBasicArraySize) {
+        value = basic->klingonY[index - kGameBasicArrayKlingonY];
+    }
+    return value;
+}
+void BasicSetAt(struct Basic *basic, int index, int value)
+{
+    if (index < kGameBasicArrayGalaxy) {
+        ;
+    } else if (index < kGameBasicArrayDamage) {
+        basic->galaxy[index - kGameBasicArrayGalaxy] = (int16_t)value;
+    } else if (index < kGameBasicArraySector) {
+        basic->damage[index - kGameBasicArrayDamage] = (int16_t)value;
+    } else if (index < kGameBasicArrayKlingonEnergy) {
+        int cell = index - kGameBasicArraySector;
+        int shift = (cell & 1) * 4;
+        int last = (basic->sector[cell >> 1] >> shift) & 0x0f;
+        if (last > kGameBasicSectorEmpty && last < kGameBasicSectorTypeSize) {
+            basic->sectorBits[last] &= ~((uint64_t)1 << cell);
+        }
+        if (value > kGameBasicSectorEmpty && value < kGameBasicSectorTypeSize) {
+            basic->sectorBits[value] |= (uint64_t)1 << cell;
+        }
+        basic->sector[cell >> 1] = (uint8_t)((basic->sector[cell >> 1] & ~(0x0f << shift)) | ((value & 0x0f) << shift));
+    } else if (index < kGameBasicArrayKlingonX) {
+        basic->klingonEnergy[index - kGameBasicArrayKlingonEnergy] = (int16_t)value;
+    } else if (index < kGameBasicArrayKlingonY) {
+        basic->klingonX[index - kGameBasicArrayKlingonX] = (int8_t)value;
+    } else if (index < kGameBasicArraySize) {
+        basic->klingonY[index - kGameBasicArrayKlingonY] = (int8_t)value;
+    }
+}
+
+// PR. の出力に追加する
+//
+static void BasicPrintString(struct BasicMachine *machine, const char *string)
+{
+    while (*string != '\0' && machine->textLength < kBasicTextSize - 1) {
+        machine->text[machine->textLength++] = *string++;
+    }
+    machine->text[machine->textLength] = '\0';
+}
+static void BasicPrintNumber(struct BasicMachine *machine, int value)
+{
+    // 符号を含めて桁数に右詰めする
+    char digits[16];
+    int length = 0;
+    unsigned int n = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[length++] = (char)('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    char string[32];
+    int i = 0;
+    for (int count = length + (value < 0 ? 1 : 0); count < machine->width && i < 16; count++) {
+        string[i++] = ' ';
+    }
+    if (value < 0) {
+        string[i++] = '-';
+    }
+    while (length > 0) {
+        string[i++] = digits[--length];
+    }
+    string[i] = '\0';
+    BasicPrintString(machine, string);
+}
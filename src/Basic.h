@@ -0,0 +1,302 @@
+// Basic.h - Tiny Basic
+//
+#pragma once
+
+// 外部参照
+//
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// Tiny Basic
+//
+enum {
+    kGameBasicArrayGalaxy = 0, 
+    kGameBasicArrayDamage = 64, 
+    kGameBasicArraySector = 71, 
+    kGameBasicArrayKlingonEnergy = 135, 
+    kGameBasicArrayKlingonX = 141, 
+    kGameBasicArrayKlingonY = 147, 
+    kGameBasicArraySize = 153, 
+};
+enum {
+    kGameBasicGalaxySize = 64, 
+    kGameBasicDamageSize = 7, 
+    kGameBasicSectorSize = 64, 
+    kGameBasicKlingonSize = 6, 
+};
+enum {
+    kGameBasicSectorEmpty = 0, 
+    kGameBasicSectorKlingon, 
+    kGameBasicSectorBase, 
+    kGameBasicSectorStar, 
+    kGameBasicSectorEnterprise, 
+    kGameBasicSectorTypeSize, 
+};
+enum {
+    kGameBasicReturnSize = 16, 
+};
+enum {
+    kGameBasicLineSize = 641, 
+};
+struct Pointer {
+    int line;
+    int sentence;
+};
+struct Basic {
+
+    // 変数
+    int A;
+    int B;
+    int C;
+    int D;
+    int E;
+    int F;
+    int G;
+    int H;
+    int I;
+    int J;
+    int K;
+    int L;
+    int M;
+    int N;
+    int O;
+    int P;
+    int Q;
+    int R;
+    int S;
+    int T;
+    int U;
+    int V;
+    int W;
+    int X;
+    int Y;
+    int Z;
+
+    // 配列 @(0..152)
+    int16_t galaxy[kGameBasicGalaxySize];
+    int16_t damage[kGameBasicDamageSize];
+    uint8_t sector[kGameBasicSectorSize / 2];
+    int16_t klingonEnergy[kGameBasicKlingonSize];
+    int8_t klingonX[kGameBasicKlingonSize];
+    int8_t klingonY[kGameBasicKlingonSize];
+
+    // セクタのビットボード（bit = 8*(I-1)+(J-1)、[0] は未使用）
+    uint64_t sectorBits[kGameBasicSectorTypeSize];
+
+    // 実行（仮想機械では sentence に命令の位置が入る）
+    struct Pointer run;
+
+    // GOSUB - RETURN
+    struct Pointer returns[kGameBasicReturnSize];
+    int returnStack;
+
+};
+
+// 仮想機械
+//
+enum {
+    kBasicVariableSize = 26, 
+    kBasicRegisterSize = 64, 
+    kBasicLoopSize = 16, 
+    kBasicIfSize = 16, 
+    kBasicCodeSize = 4096, 
+    kBasicStringSize = 4096, 
+    kBasicTextSize = 512, 
+    kBasicTextFlush = 256, 
+    kBasicWidthDefault = 6, 
+};
+enum {
+    kBasicOpLoad = 0, 
+    kBasicOpMove, 
+    kBasicOpNeg, 
+    kBasicOpAdd, 
+    kBasicOpSub, 
+    kBasicOpMul, 
+    kBasicOpDiv, 
+    kBasicOpEq, 
+    kBasicOpNe, 
+    kBasicOpLt, 
+    kBasicOpGt, 
+    kBasicOpLe, 
+    kBasicOpGe, 
+    kBasicOpAddK, 
+    kBasicOpMulK, 
+    kBasicOpDivK, 
+    kBasicOpEqK, 
+    kBasicOpNeK, 
+    kBasicOpLtK, 
+    kBasicOpGtK, 
+    kBasicOpLeK, 
+    kBasicOpGeK, 
+    kBasicOpGetAt, 
+    kBasicOpSetAt, 
+    kBasicOpRandom, 
+    kBasicOpAbs, 
+    kBasicOpSize, 
+    kBasicOpJump, 
+    kBasicOpJumpZero, 
+    kBasicOpGoto, 
+    kBasicOpGosub, 
+    kBasicOpGosubTo, 
+    kBasicOpReturn, 
+    kBasicOpFor, 
+    kBasicOpNext, 
+    kBasicOpWidth, 
+    kBasicOpWidthK, 
+    kBasicOpPrintString, 
+    kBasicOpPrintNumber, 
+    kBasicOpPrintNewLine, 
+    kBasicOpFlush, 
+    kBasicOpInput, 
+    kBasicOpStop, 
+};
+enum {
+    kBasicResultStep = 0, 
+    kBasicResultPrint, 
+    kBasicResultInput, 
+    kBasicResultStop, 
+    kBasicResultError, 
+};
+enum {
+    kBasicErrorNull = 0, 
+    kBasicErrorWhat, 
+    kBasicErrorHow, 
+    kBasicErrorSorry, 
+};
+
+// 命令（a に書き込み、b と c を読む、value は定数か飛び先）
+//
+struct BasicCode {
+    uint8_t op;
+    uint8_t a;
+    uint8_t b;
+    uint8_t c;
+    int32_t value;
+};
+
+// 行の先頭
+//
+struct BasicLine {
+    int16_t number;
+    int16_t pc;
+};
+
+// プログラム
+//
+struct BasicProgram {
+
+    // 命令
+    struct BasicCode codes[kBasicCodeSize];
+    int codeSize;
+
+    // 文字列
+    char strings[kBasicStringSize];
+    int stringSize;
+
+    // 行番号から命令の位置への索引
+    int16_t indexes[kGameBasicLineSize];
+
+    // 命令の位置の順に並べた行
+    struct BasicLine lines[kGameBasicLineSize];
+    int lineSize;
+
+    // 翻訳のエラー
+    int error;
+    int errorLine;
+
+};
+
+// 翻訳
+//
+struct BasicCompiler {
+
+    // プログラム
+    struct BasicProgram *program;
+
+    // ソース
+    const char *source;
+    int length;
+    int position;
+
+    // 行番号
+    int line;
+
+    // 一時レジスタ
+    int temporary;
+
+    // IF が偽のときに行の終わりへ飛ぶ命令
+    int ifs[kBasicIfSize];
+    int ifSize;
+
+    // エラー
+    int error;
+
+};
+struct BasicOperand {
+    bool constant;
+    int value;
+};
+typedef void (*BasicCompileFunction)(struct BasicCompiler *compiler);
+struct BasicStatement {
+    const char *keyword;
+    BasicCompileFunction function;
+};
+
+// FOR - NEXT
+//
+struct BasicLoop {
+    int variable;
+    int limit;
+    int step;
+    int pc;
+};
+
+// R.(n) の乱数
+//
+typedef int (*BasicRandom)(void *userdata, int n);
+
+// 仮想機械
+//
+struct BasicMachine {
+
+    // プログラム
+    const struct BasicProgram *program;
+
+    // レジスタ（0..25 は実行の間だけ載せた A..Z、それより上は一時）
+    int registers[kBasicRegisterSize];
+
+    // FOR - NEXT（GOSUB の間は下の段を見せない）
+    struct BasicLoop loops[kBasicLoopSize];
+    int loopSize;
+    int loopBase;
+    int loopBases[kGameBasicReturnSize];
+
+    // PR. の出力
+    char text[kBasicTextSize];
+    int textLength;
+    int width;
+
+    // IN. で待っている変数
+    int input;
+
+    // エラー
+    int error;
+
+    // 乱数
+    BasicRandom random;
+    void *userdata;
+
+};
+
+
+// 外部参照関数
+//
+extern bool BasicCompile(struct BasicProgram *program, const char *source, int length);
+extern void BasicStart(struct BasicMachine *machine, const struct BasicProgram *program, struct Basic *basic, BasicRandom random, void *userdata);
+extern int BasicRun(struct BasicMachine *machine, struct Basic *basic, int steps);
+extern int BasicFindLine(const struct BasicProgram *program, int pc);
+extern int BasicGetVariable(const struct Basic *basic, int index);
+extern void BasicSetVariable(struct Basic *basic, int index, int value);
+extern int BasicGetAt(const struct Basic *basic, int index);
+extern void BasicSetAt(struct Basic *basic, int index, int value);
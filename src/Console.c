@@ -15,10 +15,38 @@
 static void ConsoleUnload(struct Console *console);
 static void ConsoleDraw(struct Console *console);
 static void ConsoleNewLine(struct Console *console);
+static int ConsoleShapeGlyph(const char *text, struct ConsoleGlyph *glyph);
+static void ConsoleSpeedMenu(void *userdata);
+static void ConsoleHistoryMenu(void *userdata);
+static struct ConsoleWidget *ConsoleGetWidget(struct Console *console, const char **items, int size);
+static void ConsoleFreeWidget(struct ConsoleWidget *widget);
+static void ConsoleDrawNumber(struct Console *console, int number, int width, int place);
+static int ConsoleGetNumberStep(struct Console *console, float change);
+static void ConsoleAddNumber(struct Console *console, int step);
+static void ConsoleAppendHistory(struct Console *console, const char *text, int length);
+static void ConsoleAppendHistoryNumber(struct Console *console, int number);
+static void ConsoleCommitHistory(struct Console *console);
+static void ConsoleRenderHistory(struct Console *console);
 static void ConsoleLoop(struct Console *console);
 
 // 内部変数
 //
+static const char *consoleSpeedNames[] = {
+    "SLOW", 
+    "NORMAL", 
+    "FAST", 
+};
+static const float consoleSpeeds[] = {
+    15.0f, 
+    30.0f, 
+    120.0f, 
+};
+static const struct ConsoleNumberCurve consoleNumberCurves[] = {
+    {   0.0f, 0.0f,    }, 
+    {  90.0f, 0.0025f, }, 
+    { 270.0f, 0.01f,   }, 
+    { 540.0f, 0.05f,   }, 
+};
 
 
 // コンソールを初期化する
@@ -62,20 +90,42 @@ void ConsoleLoad(void)
         ActorSetTag(&console->actor, kGameTagConsole);
 
         // ビットマップの作成
-        console->bitmap = playdate->graphics->newBitmap(kConsoleBitmapSizeX, kConsoleBitmapSizeY, kColorBlack);
+        int height = IocsGetFontHeight(kIocsFontJapanese);
+        console->bitmapRows = (kConsoleBitmapSizeY + height - 1) / height;
+        console->bitmapHead = 0;
+        console->bitmap = playdate->graphics->newBitmap(kConsoleBitmapSizeX, console->bitmapRows * height, kColorBlack);
         if (console->bitmap == NULL) {
             playdate->system->error("%s: %d: console bitmap is not created.", __FILE__, __LINE__);
         }
 
+        // パネルの設定
+        IocsSetPanel(kGameOrderConsole, 0, 0, kConsoleBitmapSizeX, kConsoleBitmapSizeY, true);
+
         // 位置の設定
         console->cursorX = 0;
-        console->cursorY = kConsoleBitmapSizeY - IocsGetFontHeight(kIocsFontJapanese);
+        console->cursorY = (console->bitmapRows - 1) * height;
 
-        // テキストの設定
-        console->text = NULL;
+        // 出力キューの作成
+        console->queue = playdate->system->realloc(NULL, kConsoleQueueSize * sizeof (struct ConsoleGlyph));
+        if (console->queue == NULL) {
+            playdate->system->error("%s: %d: console queue is not allocated.", __FILE__, __LINE__);
+        }
+        console->queueHead = 0;
+        console->queueTail = 0;
+        console->shapeX = 0;
+
+        // テキストの表示の設定
+        console->printReveal = 0.0f;
+        console->printSkip = false;
+        console->printSpeed = kConsoleSpeedNormal;
+        console->printSpeedMenu = playdate->system->addOptionsMenuItem("TEXT", consoleSpeedNames, kConsoleSpeedSize, ConsoleSpeedMenu, console);
+        if (console->printSpeedMenu != NULL) {
+            playdate->system->setMenuItemValue(console->printSpeedMenu, console->printSpeed);
+        }
 
         // メニューの設定
         console->menuItems = NULL;
+        console->menuWidget = NULL;
         console->menuCrankInterval = 30.0f;
         console->menuUpdate = false;
 
@@ -87,6 +137,33 @@ void ConsoleLoad(void)
         console->angleWidth = IocsGetTextWidth(kIocsFontJapanese, "999");
         console->angleInput = -1.0f;
         console->angleUpdate = false;
+
+        // ウィジェットの設定
+        for (int i = 0; i < kConsoleWidgetSize; i++) {
+            console->widgets[i].items = NULL;
+            console->widgets[i].bitmaps = NULL;
+        }
+        console->widgetClock = 0;
+
+        // 履歴の作成
+        console->history = playdate->system->realloc(NULL, kConsoleHistorySize);
+        console->historyLines = playdate->system->realloc(NULL, kConsoleHistoryLineSize * sizeof (int));
+        if (console->history == NULL || console->historyLines == NULL) {
+            playdate->system->error("%s: %d: console history is not allocated.", __FILE__, __LINE__);
+        }
+        console->historyFirst = 0;
+        console->historyCount = 0;
+        console->historyTail = 0;
+        console->historyLength = 0;
+        console->historyBitmap = playdate->graphics->newBitmap(kConsoleBitmapSizeX, console->bitmapRows * height, kColorBlack);
+        if (console->historyBitmap == NULL) {
+            playdate->system->error("%s: %d: console history bitmap is not created.", __FILE__, __LINE__);
+        }
+        console->historyScroll = 0;
+        console->historyCrank = 0.0f;
+        console->historyUpdate = false;
+        console->historyMode = false;
+        console->historyMenu = playdate->system->addCheckmarkMenuItem("HISTORY", 0, ConsoleHistoryMenu, console);
     }
 }
 
@@ -100,10 +177,75 @@ static void ConsoleUnload(struct Console *console)
         return;
     }
 
+    // パネルの解除
+    IocsResetPanel(kGameOrderConsole);
+
     // ビットマップの解放
     if (console->bitmap != NULL) {
         playdate->graphics->freeBitmap(console->bitmap);
     }
+
+    // 出力キューの解放
+    if (console->queue != NULL) {
+        playdate->system->realloc(console->queue, 0);
+    }
+
+    // メニュー項目の解放
+    if (console->printSpeedMenu != NULL) {
+        playdate->system->removeMenuItem(console->printSpeedMenu);
+    }
+    if (console->historyMenu != NULL) {
+        playdate->system->removeMenuItem(console->historyMenu);
+    }
+
+    // ウィジェットの解放
+    for (int i = 0; i < kConsoleWidgetSize; i++) {
+        ConsoleFreeWidget(&console->widgets[i]);
+    }
+
+    // 履歴の解放
+    if (console->history != NULL) {
+        playdate->system->realloc(console->history, 0);
+    }
+    if (console->historyLines != NULL) {
+        playdate->system->realloc(console->historyLines, 0);
+    }
+    if (console->historyBitmap != NULL) {
+        playdate->graphics->freeBitmap(console->historyBitmap);
+    }
+}
+
+// 表示速度が選択された
+//
+static void ConsoleSpeedMenu(void *userdata)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 表示速度の設定
+    struct Console *console = (struct Console *)userdata;
+    int speed = playdate->system->getMenuItemValue(console->printSpeedMenu);
+    if (speed >= 0 && speed < kConsoleSpeedSize) {
+        console->printSpeed = speed;
+    }
+}
+
+// 履歴の表示が切り替えられた
+//
+static void ConsoleHistoryMenu(void *userdata)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 履歴の表示の設定
+    struct Console *console = (struct Console *)userdata;
+    console->historyMode = playdate->system->getMenuItemValue(console->historyMenu) != 0 ? true : false;
 }
 
 // コンソールを描画する
@@ -116,48 +258,24 @@ static void ConsoleDraw(struct Console *console)
         return;
     }
 
-    // テキストの描画
-    if (console->text != NULL) {
-        bool skip = (IocsIsButtonPush(kButtonB) || IocsIsButtonPush(kButtonLeft)) ? true : false;
-        do {
-            char letter[8];
-            int length = IocsGetCharByte(*console->text);
-            {
-                strncpy(letter, console->text, length);
-                letter[length] = '\0';
-                console->text += length;
-                if (*console->text == '\0') {
-                    console->text = NULL;
-                }
-            }
-            if (letter[0] == '\n') {
-                ConsoleNewLine(console);
-            } else {
-                int width = IocsGetTextWidth(kIocsFontJapanese, letter);
-                int height = IocsGetFontHeight(kIocsFontJapanese);
-                if (console->cursorX + width > kConsoleBitmapSizeX) {
-                    ConsoleNewLine(console);
-                }
-                playdate->graphics->pushContext(console->bitmap);
-                IocsSetFont(kIocsFontJapanese);
-                playdate->graphics->setDrawMode(kDrawModeFillWhite);
-                playdate->graphics->drawText(letter, length, kUTF8Encoding, console->cursorX, console->cursorY);
-                playdate->graphics->popContext();
-                console->cursorX += width;
-            }
-        } while (skip && console->text != NULL);
+    // 入力中の表示はテキストの表示を待つ
+    bool printing = console->queueHead != console->queueTail ? true : false;
 
     // メニューの描画
-    } else if (console->menuUpdate) {
+    if (console->menuUpdate && (console->menuItems == NULL || !printing)) {
         if (console->menuItems != NULL) {
-            const char *text = console->menuItems[console->menuCursor];
-            int height = IocsGetFontHeight(kIocsFontJapanese);
             playdate->graphics->pushContext(console->bitmap);
-            IocsSetFont(kIocsFontJapanese);
             playdate->graphics->setDrawMode(kDrawModeCopy);
-            playdate->graphics->fillRect(console->cursorX, console->cursorY, console->menuWidth, height, kColorWhite);
-            playdate->graphics->setDrawMode(kDrawModeFillBlack);
-            playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, console->cursorX, console->cursorY);
+            if (console->menuWidget != NULL && console->menuWidget->bitmaps[console->menuCursor] != NULL) {
+                playdate->graphics->drawBitmap(console->menuWidget->bitmaps[console->menuCursor], console->cursorX, console->cursorY, kBitmapUnflipped);
+            } else {
+                const char *text = console->menuItems[console->menuCursor];
+                int height = IocsGetFontHeight(kIocsFontJapanese);
+                IocsSetFont(kIocsFontJapanese);
+                playdate->graphics->fillRect(console->cursorX, console->cursorY, console->menuWidth, height, kColorWhite);
+                playdate->graphics->setDrawMode(kDrawModeFillBlack);
+                playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, console->cursorX, console->cursorY);
+            }
             playdate->graphics->popContext();
         } else {
             ConsoleNewLine(console);
@@ -165,42 +283,79 @@ static void ConsoleDraw(struct Console *console)
         console->menuUpdate = false;
 
     // 数値入力の描画
-    } else if (console->numberUpdate) {
+    } else if (console->numberUpdate && (console->numberInput < 0 || !printing)) {
         if (console->numberInput >= 0) {
-            char *text;
-            playdate->system->formatString(&text, "%d", console->numberInput);
-            int height = IocsGetFontHeight(kIocsFontJapanese);
-            playdate->graphics->pushContext(console->bitmap);
-            IocsSetFont(kIocsFontJapanese);
-            playdate->graphics->setDrawMode(kDrawModeCopy);
-            playdate->graphics->fillRect(console->cursorX, console->cursorY, console->numberWidth, height, kColorWhite);
-            playdate->graphics->setDrawMode(kDrawModeFillBlack);
-            playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, console->cursorX, console->cursorY);
-            playdate->graphics->popContext();
-            playdate->system->realloc(text, 0);
+            ConsoleDrawNumber(console, console->numberInput, console->numberWidth, console->numberPlace);
         } else {
             ConsoleNewLine(console);
         }
         console->numberUpdate = false;
 
     // 角度入力の描画
-    } else if (console->angleUpdate) {
+    } else if (console->angleUpdate && (console->angleInput < 0.0f || !printing)) {
         if (console->angleInput >= 0.0f) {
-            char *text;
-            playdate->system->formatString(&text, "%d", (int)console->angleInput);
-            int height = IocsGetFontHeight(kIocsFontJapanese);
-            playdate->graphics->pushContext(console->bitmap);
-            IocsSetFont(kIocsFontJapanese);
-            playdate->graphics->setDrawMode(kDrawModeCopy);
-            playdate->graphics->fillRect(console->cursorX, console->cursorY, console->angleWidth, height, kColorWhite);
-            playdate->graphics->setDrawMode(kDrawModeFillBlack);
-            playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, console->cursorX, console->cursorY);
-            playdate->graphics->popContext();
-            playdate->system->realloc(text, 0);
+            ConsoleDrawNumber(console, (int)console->angleInput, console->angleWidth, -1);
         } else {
             ConsoleNewLine(console);
         }
         console->angleUpdate = false;
+
+    // テキストの描画
+    } else if (printing) {
+
+        // 表示するグリフ数の取得
+        int used = (console->queueTail - console->queueHead + kConsoleQueueSize) % kConsoleQueueSize;
+        int count = console->printSkip ? used : (int)console->printReveal;
+        if (count > used) {
+            count = used;
+        }
+        console->printReveal = console->printSkip ? 0.0f : console->printReveal - (float)count;
+
+        // グリフの描画（スキップでは 1 フレームに画面の行数分まで流す）
+        playdate->graphics->pushContext(console->bitmap);
+        playdate->graphics->setDrawMode(kDrawModeFillWhite);
+        IocsSetFont(kIocsFontJapanese);
+        for (int i = 0, line = 0; i < count; i++) {
+            struct ConsoleGlyph *glyph = &console->queue[console->queueHead];
+            if ((glyph->flags & (kConsoleGlyphNewLine | kConsoleGlyphBreak)) != 0) {
+                if (console->printSkip && line >= console->bitmapRows) {
+                    break;
+                }
+                ConsoleNewLine(console);
+                ++line;
+            }
+            console->queueHead = (console->queueHead + 1) % kConsoleQueueSize;
+            if ((glyph->flags & kConsoleGlyphNewLine) == 0) {
+                ConsoleAppendHistory(console, glyph->letter, glyph->length);
+                if ((glyph->flags & kConsoleGlyphCached) != 0) {
+                    if (glyph->bitmap != NULL) {
+                        playdate->graphics->drawBitmap(glyph->bitmap, console->cursorX, console->cursorY, kBitmapUnflipped);
+                    }
+                } else {
+                    playdate->graphics->drawText(glyph->letter, glyph->length, kUTF8Encoding, console->cursorX, console->cursorY);
+                }
+                console->cursorX += glyph->advance;
+            }
+        }
+        playdate->graphics->popContext();
+    }
+
+    // ビットマップの描画
+    {
+        int height = IocsGetFontHeight(kIocsFontJapanese);
+        int y = kConsoleBitmapSizeY - console->bitmapRows * height;
+        if (console->historyScroll > 0 && console->historyBitmap != NULL) {
+            if (console->historyUpdate) {
+                ConsoleRenderHistory(console);
+            }
+            IocsDrawPanelBitmap(kGameOrderConsole, console->historyBitmap, 0, y);
+        } else {
+            IocsDrawPanelBitmap(kGameOrderConsole, console->bitmap, 0, y - console->bitmapHead * height);
+            if (console->bitmapHead > 0) {
+                IocsDrawPanelBitmap(kGameOrderConsole, console->bitmap, 0, y + (console->bitmapRows - console->bitmapHead) * height);
+            }
+        }
+        console->historyUpdate = false;
     }
 
     // タイトルの描画
@@ -208,7 +363,7 @@ static void ConsoleDraw(struct Console *console)
         int height0 = IocsGetFontHeight(kIocsFontJapanese);
         int height1 = IocsGetFontHeight(kIocsFontMini);
         int row = 5;
-        playdate->graphics->pushContext(console->bitmap);
+        playdate->graphics->pushContext(NULL);
         IocsSetFont(kIocsFontMini);
         playdate->graphics->fillRect(0, kConsoleBitmapSizeY - row * height0 + 0 * height1, kConsoleBitmapSizeX, height0, kColorBlack);
         char *text = "CONSOLE";
@@ -216,10 +371,6 @@ static void ConsoleDraw(struct Console *console)
         playdate->graphics->drawLine(0, kConsoleBitmapSizeY - row * height0 + 1 * height1, kConsoleBitmapSizeX - 1, kConsoleBitmapSizeY - row * height0 + 1 * height1, 1, kColorWhite);
         playdate->graphics->popContext();
     }
-
-    // ビットマップの描画
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->drawBitmap(console->bitmap, 0, 0, kBitmapUnflipped);
 }
 
 // 改行する
@@ -232,22 +383,303 @@ static void ConsoleNewLine(struct Console *console)
         return;
     }
 
-    // 改行
+    // 改行（先頭の行を消去して末尾の行として再利用する）
     {
         int height = IocsGetFontHeight(kIocsFontJapanese);
+        int row = console->bitmapHead;
+        console->bitmapHead = (console->bitmapHead + 1) % console->bitmapRows;
+        playdate->graphics->pushContext(console->bitmap);
+        playdate->graphics->setDrawMode(kDrawModeCopy);
+        playdate->graphics->fillRect(0, row * height, kConsoleBitmapSizeX, height, kColorBlack);
+        playdate->graphics->popContext();
         console->cursorX = 0;
-        console->cursorY += height;
-        if (console->cursorY + height > kConsoleBitmapSizeY) {
-            playdate->graphics->pushContext(console->bitmap);
-            playdate->graphics->setDrawMode(kDrawModeCopy);
-            playdate->graphics->drawBitmap(console->bitmap, 0, -height, kBitmapUnflipped);
-            playdate->graphics->fillRect(0, kConsoleBitmapSizeY - height, kConsoleBitmapSizeX, height, kColorBlack);
-            playdate->graphics->popContext();
-            console->cursorY = kConsoleBitmapSizeY - height;
+        console->cursorY = row * height;
+    }
+
+    // 行を履歴に残す
+    ConsoleCommitHistory(console);
+}
+
+// 履歴の現在の行にテキストを追加する
+//
+static void ConsoleAppendHistory(struct Console *console, const char *text, int length)
+{
+    while (length > 0) {
+
+        // 収まらない分は UTF-8 の文字の境目で次の行に送る
+        int size = kConsoleHistoryLineLength - 1 - console->historyLength;
+        if (size >= length) {
+            size = length;
+        } else {
+            while (size > 0 && (text[size] & 0xc0) == 0x80) {
+                --size;
+            }
+        }
+        memcpy(&console->historyLine[console->historyLength], text, size);
+        console->historyLength += size;
+        text += size;
+        length -= size;
+        if (length > 0) {
+            ConsoleCommitHistory(console);
+        }
+    }
+}
+
+// 履歴の現在の行に数値を追加する
+//
+static void ConsoleAppendHistoryNumber(struct Console *console, int number)
+{
+    char digits[12];
+    int length = 0;
+    do {
+        digits[length++] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0 && length < (int)sizeof (digits));
+    while (length > 0) {
+        ConsoleAppendHistory(console, &digits[--length], 1);
+    }
+}
+
+// 履歴の現在の行を確定する
+//
+static void ConsoleCommitHistory(struct Console *console)
+{
+    if (console->history == NULL || console->historyLines == NULL) {
+        return;
+    }
+
+    // 末尾に収まらなければ先頭に戻る
+    int size = console->historyLength + 1;
+    if (console->historyTail + size > kConsoleHistorySize) {
+        console->historyTail = 0;
+    }
+
+    // 上書きされる古い行を捨てる
+    while (console->historyCount > 0) {
+        int start = console->historyLines[console->historyFirst];
+        int end = start + (int)strlen(&console->history[start]) + 1;
+        if (
+            console->historyCount < kConsoleHistoryLineSize && 
+            (end <= console->historyTail || start >= console->historyTail + size)
+        ) {
+            break;
+        }
+        console->historyFirst = (console->historyFirst + 1) % kConsoleHistoryLineSize;
+        --console->historyCount;
+    }
+
+    // 行の追加
+    memcpy(&console->history[console->historyTail], console->historyLine, console->historyLength);
+    console->history[console->historyTail + console->historyLength] = '\0';
+    console->historyLines[(console->historyFirst + console->historyCount) % kConsoleHistoryLineSize] = console->historyTail;
+    console->historyTail += size;
+    ++console->historyCount;
+    console->historyLength = 0;
+
+    // 履歴の表示中は表示している行を保つ
+    if (console->historyScroll > 0 && console->historyScroll < console->historyCount) {
+        ++console->historyScroll;
+    }
+}
+
+// 履歴から表示する範囲の行を描画する
+//
+static void ConsoleRenderHistory(struct Console *console)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 最下行をスクロール量だけ遡った行にして描画する
+    int height = IocsGetFontHeight(kIocsFontJapanese);
+    playdate->graphics->pushContext(console->historyBitmap);
+    playdate->graphics->setDrawMode(kDrawModeCopy);
+    playdate->graphics->fillRect(0, 0, kConsoleBitmapSizeX, console->bitmapRows * height, kColorBlack);
+    playdate->graphics->setDrawMode(kDrawModeFillWhite);
+    IocsSetFont(kIocsFontJapanese);
+    for (int row = 0; row < console->bitmapRows; row++) {
+        int index = console->historyCount - console->historyScroll - (console->bitmapRows - 1 - row);
+        if (index >= 0 && index < console->historyCount) {
+            const char *text = &console->history[console->historyLines[(console->historyFirst + index) % kConsoleHistoryLineSize]];
+            playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, 0, row * height);
+        }
+    }
+    playdate->graphics->popContext();
+}
+
+// 入力中の数値を描画する
+//
+static void ConsoleDrawNumber(struct Console *console, int number, int width, int place)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 数字の並びの取得
+    char digits[12];
+    int length = 0;
+    do {
+        digits[length++] = '0' + number % 10;
+        number /= 10;
+    } while (number > 0 && length < (int)sizeof (digits));
+
+    // 数値の描画
+    int height = IocsGetFontHeight(kIocsFontJapanese);
+    int x = console->cursorX;
+    playdate->graphics->pushContext(console->bitmap);
+    IocsSetFont(kIocsFontJapanese);
+    playdate->graphics->setDrawMode(kDrawModeCopy);
+    playdate->graphics->fillRect(console->cursorX, console->cursorY, width, height, kColorWhite);
+    playdate->graphics->setDrawMode(kDrawModeFillBlack);
+    while (length > 0) {
+        char c = digits[--length];
+        LCDBitmap *bitmap;
+        int advance;
+        if (IocsGetGlyph(kIocsFontJapanese, c, &bitmap, &advance)) {
+            if (bitmap != NULL) {
+                playdate->graphics->drawBitmap(bitmap, x, console->cursorY, kBitmapUnflipped);
+            }
+        } else {
+            char text[2] = { c, '\0', };
+            playdate->graphics->drawText(text, 1, kUTF8Encoding, x, console->cursorY);
+            advance = IocsGetTextWidth(kIocsFontJapanese, text);
+        }
+        if (length == place) {
+            playdate->graphics->fillRect(x, console->cursorY + height - 2, advance, 2, kColorBlack);
+        }
+        x += advance;
+    }
+    playdate->graphics->popContext();
+}
+
+// クランクの回転速度から数値の増減量を取得する
+//
+static int ConsoleGetNumberStep(struct Console *console, float change)
+{
+    // 桁が選択されていればその桁を増減する
+    if (console->numberPlace >= 0) {
+        int step = 1;
+        for (int i = 0; i < console->numberPlace; i++) {
+            step *= 10;
         }
+        return step;
+    }
+
+    // 回転速度に応じて範囲に対する割合で増減する
+    float delta = IocsGetFrameDelta();
+    float velocity = delta > 0.0f ? (change >= 0.0f ? change : -change) / delta : 0.0f;
+    float ratio = 0.0f;
+    for (int i = 0; i < (int)(sizeof (consoleNumberCurves) / sizeof (struct ConsoleNumberCurve)); i++) {
+        if (velocity >= consoleNumberCurves[i].velocity) {
+            ratio = consoleNumberCurves[i].ratio;
+        }
+    }
+    int step = (int)((float)(console->numberMaximum - console->numberMinimum) * ratio);
+    return step > 1 ? step : 1;
+}
+
+// 入力中の数値を増減する
+//
+static void ConsoleAddNumber(struct Console *console, int step)
+{
+    // 1 ずつの増減は範囲を循環し、それ以上は範囲で止める
+    int number = console->numberInput + step;
+    if (number < console->numberMinimum) {
+        number = step == -1 ? console->numberMaximum : console->numberMinimum;
+    } else if (number > console->numberMaximum) {
+        number = step == 1 ? console->numberMinimum : console->numberMaximum;
+    }
+    if (number != console->numberInput) {
+        console->numberInput = number;
+        console->numberUpdate = true;
     }
 }
 
+// メニューのウィジェットを取得する
+//
+static struct ConsoleWidget *ConsoleGetWidget(struct Console *console, const char **items, int size)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return NULL;
+    }
+
+    // 作成済みのウィジェットの検索
+    ++console->widgetClock;
+    struct ConsoleWidget *widget = NULL;
+    for (int i = 0; i < kConsoleWidgetSize; i++) {
+        if (console->widgets[i].items == items && console->widgets[i].size == size) {
+            console->widgets[i].used = console->widgetClock;
+            return &console->widgets[i];
+        }
+        if (widget == NULL || (widget->items != NULL && (console->widgets[i].items == NULL || console->widgets[i].used < widget->used))) {
+            widget = &console->widgets[i];
+        }
+    }
+
+    // 最も古いウィジェットを作り直す
+    ConsoleFreeWidget(widget);
+    widget->bitmaps = playdate->system->realloc(NULL, size * sizeof (LCDBitmap *));
+    if (widget->bitmaps == NULL) {
+        playdate->system->error("%s: %d: console widget is not allocated.", __FILE__, __LINE__);
+        return NULL;
+    }
+    widget->items = items;
+    widget->size = size;
+    widget->width = 0;
+    widget->used = console->widgetClock;
+    for (int i = 0; i < size; i++) {
+        int width = IocsGetTextWidth(kIocsFontJapanese, items[i]);
+        if (widget->width < width) {
+            widget->width = width;
+        }
+    }
+
+    // 項目毎に強調表示を描画しておく
+    {
+        int height = IocsGetFontHeight(kIocsFontJapanese);
+        for (int i = 0; i < size; i++) {
+            widget->bitmaps[i] = playdate->graphics->newBitmap(widget->width > 0 ? widget->width : 1, height, kColorWhite);
+            if (widget->bitmaps[i] != NULL) {
+                playdate->graphics->pushContext(widget->bitmaps[i]);
+                IocsSetFont(kIocsFontJapanese);
+                playdate->graphics->setDrawMode(kDrawModeFillBlack);
+                playdate->graphics->drawText(items[i], strlen(items[i]), kUTF8Encoding, 0, 0);
+                playdate->graphics->popContext();
+            }
+        }
+    }
+    return widget;
+}
+
+// メニューのウィジェットを解放する
+//
+static void ConsoleFreeWidget(struct ConsoleWidget *widget)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // ビットマップの解放
+    if (widget->bitmaps != NULL) {
+        for (int i = 0; i < widget->size; i++) {
+            if (widget->bitmaps[i] != NULL) {
+                playdate->graphics->freeBitmap(widget->bitmaps[i]);
+            }
+        }
+        playdate->system->realloc(widget->bitmaps, 0);
+        widget->bitmaps = NULL;
+    }
+    widget->items = NULL;
+}
+
 // コンソールが待機する
 //
 static void ConsoleLoop(struct Console *console)
@@ -265,8 +697,16 @@ static void ConsoleLoop(struct Console *console)
         ++console->actor.state;
     }
 
+    // 履歴の表示中はウィジェットに入力を渡さない
+    if (console->historyMode) {
+        ;
+
+    // テキストの表示中は入力を受け付けない
+    } else if (console->queueHead != console->queueTail) {
+        ;
+
     // メニューの更新
-    if (console->menuItems != NULL) {
+    } else if (console->menuItems != NULL) {
         {
             bool beep = false;
             console->menuCrank += IocsGetCrankChange();
@@ -293,9 +733,11 @@ static void ConsoleLoop(struct Console *console)
             }
         }
         if (IocsIsButtonEdge(kButtonA) || IocsIsButtonEdge(kButtonRight)) {
+            ConsoleAppendHistory(console, console->menuItems[console->menuCursor], strlen(console->menuItems[console->menuCursor]));
             console->menuItems = NULL;
             console->menuDone = console->menuCursor;
             console->menuUpdate = true;
+            console->shapeX = 0;
             IocsPlayAudioSystem(kIocsAudioSystemSamplePi, 1);
         /*
         } else if (IocsIsButtonRepeat(kButtonUp)) {
@@ -319,22 +761,16 @@ static void ConsoleLoop(struct Console *console)
     } else if (console->numberInput >= 0) {
         {
             bool beep = false;
-            console->numberCrank += IocsGetCrankChange();
+            float change = IocsGetCrankChange();
+            int step = ConsoleGetNumberStep(console, change);
+            console->numberCrank += change;
             while (console->numberCrank <= -console->numberCrankInterval) {
-                --console->numberInput;
-                if (console->numberInput < console->numberMinimum) {
-                    console->numberInput = console->numberMaximum;
-                }
-                console->numberUpdate = true;
+                ConsoleAddNumber(console, -step);
                 console->numberCrank += console->numberCrankInterval;
                 beep = true;
             }
             while (console->numberCrank >= console->numberCrankInterval) {
-                ++console->numberInput;
-                if (console->numberInput > console->numberMaximum) {
-                    console->numberInput = console->numberMinimum;
-                }
-                console->numberUpdate = true;
+                ConsoleAddNumber(console, step);
                 console->numberCrank -= console->numberCrankInterval;
                 beep = true;
             }
@@ -343,46 +779,113 @@ static void ConsoleLoop(struct Console *console)
             }
         }
         if (IocsIsButtonEdge(kButtonA) || IocsIsButtonEdge(kButtonRight)) {
+            ConsoleAppendHistoryNumber(console, console->numberInput);
             console->numberDone = console->numberInput;
             console->numberInput = -1;
             console->numberUpdate = true;
+            console->shapeX = 0;
             IocsPlayAudioSystem(kIocsAudioSystemSamplePi, 1);
         } else if (IocsIsButtonEdge(kButtonB) || IocsIsButtonEdge(kButtonLeft)) {
+            ConsoleAppendHistoryNumber(console, console->numberInput);
             console->numberDone = -1;
             console->numberInput = -1;
             console->numberUpdate = true;
+            console->shapeX = 0;
             IocsPlayAudioSystem(kIocsAudioSystemSamplePo, 1);
-        /*
-        } else if (IocsIsButtonRepeat(kButtonUp)) {
-            --console->numberInput;
-            if (console->numberInput < console->numberMinimum) {
-                console->numberInput = console->numberMaximum;
+        } else if (IocsIsButtonEdge(kButtonUp)) {
+            if (console->numberPlace < console->numberDigit - 1) {
+                ++console->numberPlace;
+                console->numberCrank = 0.0f;
+                console->numberUpdate = true;
+                IocsPlayAudioSystem(kIocsAudioSystemSamplePo, 1);
             }
-            console->numberUpdate = true;
-            IocsPlayAudioSystem(kIocsAudioSystemSamplePo, 1);
-        } else if (IocsIsButtonRepeat(kButtonDown)) {
-            ++console->numberInput;
-            if (console->numberInput > console->numberMaximum) {
-                console->numberInput = console->numberMinimum;
+        } else if (IocsIsButtonEdge(kButtonDown)) {
+            if (console->numberPlace >= 0) {
+                --console->numberPlace;
+                console->numberCrank = 0.0f;
+                console->numberUpdate = true;
+                IocsPlayAudioSystem(kIocsAudioSystemSamplePo, 1);
             }
-            console->numberUpdate = true;
-            IocsPlayAudioSystem(kIocsAudioSystemSamplePo, 1);
-        */
         }
 
     // 角度入力の更新
     } else if (console->angleInput >= 0.0f) {
         if (IocsIsButtonEdge(kButtonA) || IocsIsButtonEdge(kButtonRight)) {
+            ConsoleAppendHistoryNumber(console, (int)console->angleInput);
             console->angleDone = console->angleInput;
             console->angleInput = -1.0f;
             console->angleUpdate = true;
+            console->shapeX = 0;
             IocsPlayAudioSystem(kIocsAudioSystemSamplePi, 1);
         } else {
-            console->angleInput = IocsGetCrankAngle();
-            console->angleUpdate = true;
+            float angle = IocsGetCrankAngle();
+            if ((int)angle != (int)console->angleInput) {
+                console->angleInput = angle;
+                console->angleUpdate = true;
+            }
         }
     }
 
+    // 履歴の表示の更新（HISTORY がオンの間はクランクと上下で遡る）
+    {
+        int scroll = console->historyScroll;
+        if (!console->historyMode) {
+            scroll = 0;
+            console->historyCrank = 0.0f;
+        } else {
+            console->historyCrank += IocsGetCrankChange();
+            while (console->historyCrank <= -kConsoleHistoryCrankInterval) {
+                ++scroll;
+                console->historyCrank += kConsoleHistoryCrankInterval;
+            }
+            while (console->historyCrank >= kConsoleHistoryCrankInterval) {
+                --scroll;
+                console->historyCrank -= kConsoleHistoryCrankInterval;
+            }
+            if (IocsIsButtonRepeat(kButtonUp)) {
+                ++scroll;
+            } else if (IocsIsButtonRepeat(kButtonDown)) {
+                --scroll;
+            }
+            if (scroll > console->historyCount) {
+                scroll = console->historyCount;
+            } else if (scroll < 0) {
+                scroll = 0;
+            }
+        }
+        if (scroll != console->historyScroll) {
+            console->historyScroll = scroll;
+            console->historyUpdate = true;
+        }
+    }
+
+    // テキストの表示量の更新
+    if (console->queueHead != console->queueTail) {
+        console->printSkip = (IocsIsButtonPush(kButtonB) || IocsIsButtonPush(kButtonLeft)) ? true : false;
+        console->printReveal += IocsGetFrameDelta() * consoleSpeeds[console->printSpeed];
+        IocsBoostFrameRate();
+    } else {
+        console->printSkip = false;
+        console->printReveal = 0.0f;
+    }
+
+    // 更新行の設定
+    if (
+        (console->menuUpdate && console->menuItems == NULL) || 
+        (console->numberUpdate && console->numberInput < 0) || 
+        (console->angleUpdate && console->angleInput < 0.0f) || 
+        console->historyUpdate
+    ) {
+        IocsMarkDirtyAll();
+    } else if (console->queueHead != console->queueTail) {
+        if (console->printSkip || console->printReveal >= 1.0f) {
+            IocsMarkDirtyAll();
+        }
+    } else if (console->menuUpdate || console->numberUpdate || console->angleUpdate) {
+        int height = IocsGetFontHeight(kIocsFontJapanese);
+        IocsMarkDirty(kConsoleBitmapSizeY - height, height);
+    }
+
     // 描画処理の設定
     ActorSetDraw(&console->actor, (ActorFunction)ConsoleDraw, kGameOrderConsole);
 }
@@ -397,8 +900,88 @@ void ConsolePrintText(const char *text)
         return;
     }
 
-    // テキストの設定
-    console->text = text;
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // テキストを整形して出力キューへ追加する
+    bool word = false;
+    while (*text != '\0') {
+        struct ConsoleGlyph glyph;
+        int length = ConsoleShapeGlyph(text, &glyph);
+        if (glyph.letter[0] == '\n') {
+            glyph.flags |= kConsoleGlyphNewLine;
+            console->shapeX = 0;
+            word = false;
+        } else if (glyph.letter[0] == ' ') {
+            word = false;
+        } else if (!word) {
+
+            // 単語が行に収まらなければ単語の前で改行する
+            int width = 0;
+            for (const char *next = text; *next != '\0' && *next != ' ' && *next != '\n'; ) {
+                struct ConsoleGlyph letter;
+                next += ConsoleShapeGlyph(next, &letter);
+                width += letter.advance;
+            }
+            if (console->shapeX > 0 && console->shapeX + width > kConsoleBitmapSizeX && width <= kConsoleBitmapSizeX) {
+                glyph.flags |= kConsoleGlyphBreak;
+                console->shapeX = 0;
+            }
+            word = true;
+        }
+        if ((glyph.flags & kConsoleGlyphNewLine) == 0) {
+            if ((glyph.flags & kConsoleGlyphBreak) == 0 && console->shapeX + glyph.advance > kConsoleBitmapSizeX) {
+                glyph.flags |= kConsoleGlyphBreak;
+                console->shapeX = 0;
+            }
+            console->shapeX += glyph.advance;
+        }
+        int tail = (console->queueTail + 1) % kConsoleQueueSize;
+        if (tail == console->queueHead) {
+            playdate->system->error("%s: %d: console queue is overflowed.", __FILE__, __LINE__);
+            break;
+        }
+        console->queue[console->queueTail] = glyph;
+        console->queueTail = tail;
+        text += length;
+    }
+}
+
+// 1 文字を整形する
+//
+static int ConsoleShapeGlyph(const char *text, struct ConsoleGlyph *glyph)
+{
+    int length = IocsGetCharByte(*text);
+    if (length > 4) {
+        length = 1;
+    }
+    for (int i = 0; i < length; i++) {
+        if (text[i] == '\0') {
+            length = i;
+            break;
+        }
+        glyph->letter[i] = text[i];
+    }
+    glyph->bitmap = NULL;
+    glyph->advance = 0;
+    glyph->length = (uint8_t)length;
+    glyph->flags = 0;
+    if (glyph->letter[0] != '\n') {
+        int advance = 0;
+        if (length == 1 && IocsGetGlyph(kIocsFontJapanese, glyph->letter[0], &glyph->bitmap, &advance)) {
+            glyph->flags |= kConsoleGlyphCached;
+        } else {
+            char letter[8];
+            memcpy(letter, glyph->letter, length);
+            letter[length] = '\0';
+            advance = IocsGetTextWidth(kIocsFontJapanese, letter);
+        }
+        glyph->advance = (int16_t)advance;
+    }
+    return length;
 }
 
 // テキストの表示が完了したかどうかを判定する
@@ -406,7 +989,20 @@ void ConsolePrintText(const char *text)
 bool ConsoleIsPrintText(void)
 {
     struct Console *console = (struct Console *)ActorFindWithTag(kGameTagConsole);
-    return (console != NULL && console->text != NULL) ? true : false;
+    return (console != NULL && console->queueHead != console->queueTail) ? true : false;
+}
+
+// 出力キューに指定の長さのテキストを追加できるかどうかを判定する
+//
+bool ConsoleIsPrintable(int length)
+{
+    struct Console *console = (struct Console *)ActorFindWithTag(kGameTagConsole);
+    if (console == NULL) {
+        return false;
+    }
+    // 1 バイトが最大で 1 グリフになるので、バイト数で空きを判定する
+    int used = (console->queueTail - console->queueHead + kConsoleQueueSize) % kConsoleQueueSize;
+    return kConsoleQueueSize - 1 - used >= length ? true : false;
 }
 
 // メニューを開く
@@ -421,16 +1017,21 @@ void ConsoleOpenMenu(const char **items, int size)
 
     // メニューの設定
     console->menuItems = items;
+    console->menuWidget = ConsoleGetWidget(console, items, size);
     console->menuSize = size;
     console->menuWidth = 0;
     console->menuCursor = 0;
     console->menuDone = -1;
     console->menuCrank = 0.0f;
     console->menuUpdate = true;
-    for (int i = 0; i < size; i++) {
-        int width = IocsGetTextWidth(kIocsFontJapanese, items[i]);
-        if (console->menuWidth < width) {
-            console->menuWidth = width;
+    if (console->menuWidget != NULL) {
+        console->menuWidth = console->menuWidget->width;
+    } else {
+        for (int i = 0; i < size; i++) {
+            int width = IocsGetTextWidth(kIocsFontJapanese, items[i]);
+            if (console->menuWidth < width) {
+                console->menuWidth = width;
+            }
         }
     }
 }
@@ -463,6 +1064,7 @@ void ConsoleInputNumber(int number, int minimum, int maximum)
 
     // 数値入力の設定
     console->numberDigit = 0;
+    console->numberPlace = -1;
     console->numberWidth = 0;
     console->numberMinimum = minimum;
     console->numberMaximum = maximum;
@@ -484,7 +1086,7 @@ void ConsoleInputNumber(int number, int minimum, int maximum)
         console->numberDigit = 4;
         console->numberWidth = IocsGetTextWidth(kIocsFontJapanese, "9999");
     }
-    console->numberCrankInterval = (float)(360 / (maximum - minimum));
+    console->numberCrankInterval = maximum > minimum ? (float)(360 / (maximum - minimum)) : 10.0f;
     if (console->numberCrankInterval < 1.0f) {
         console->numberCrankInterval = 1.0f;
     } else if (console->numberCrankInterval > 10.0f) {
@@ -16,6 +16,50 @@ enum {
     kConsoleBitmapSizeY = 240, 
 };
 
+// 出力キュー
+//
+enum {
+    kConsoleQueueSize = 2048, 
+};
+enum {
+    kConsoleGlyphNewLine = 0x01, 
+    kConsoleGlyphBreak = 0x02, 
+    kConsoleGlyphCached = 0x04, 
+};
+enum {
+    kConsoleSpeedSlow = 0, 
+    kConsoleSpeedNormal, 
+    kConsoleSpeedFast, 
+    kConsoleSpeedSize, 
+};
+enum {
+    kConsoleWidgetSize = 4, 
+};
+enum {
+    kConsoleHistorySize = 64 * 1024, 
+    kConsoleHistoryLineSize = 4096, 
+    kConsoleHistoryLineLength = 128, 
+    kConsoleHistoryCrankInterval = 15, 
+};
+struct ConsoleWidget {
+    const char **items;
+    int size;
+    int width;
+    LCDBitmap **bitmaps;
+    unsigned int used;
+};
+struct ConsoleNumberCurve {
+    float velocity;
+    float ratio;
+};
+struct ConsoleGlyph {
+    LCDBitmap *bitmap;
+    int16_t advance;
+    uint8_t length;
+    uint8_t flags;
+    char letter[4];
+};
+
 // コンソール
 //
 struct Console {
@@ -23,18 +67,30 @@ struct Console {
     // アクタ
     struct Actor actor;
 
-    // ビットマップ
+    // ビットマップ（行の循環バッファ）
     LCDBitmap *bitmap;
+    int bitmapRows;
+    int bitmapHead;
 
     // カーソル位置
     int cursorX;
     int cursorY;
 
-    // テキスト
-    const char *text;
+    // 出力キュー（整形済みのグリフ）
+    struct ConsoleGlyph *queue;
+    int queueHead;
+    int queueTail;
+    int shapeX;
+
+    // テキストの表示
+    float printReveal;
+    bool printSkip;
+    int printSpeed;
+    PDMenuItem *printSpeedMenu;
 
     // メニュー
     const char **menuItems;
+    struct ConsoleWidget *menuWidget;
     int menuSize;
     int menuWidth;
     int menuCursor;
@@ -45,6 +101,7 @@ struct Console {
 
     // 数値入力
     int numberDigit;
+    int numberPlace;
     int numberWidth;
     int numberMinimum;
     int numberMaximum;
@@ -60,6 +117,25 @@ struct Console {
     float angleDone;
     bool angleUpdate;
 
+    // ウィジェット
+    struct ConsoleWidget widgets[kConsoleWidgetSize];
+    unsigned int widgetClock;
+
+    // 履歴
+    char *history;
+    int *historyLines;
+    int historyFirst;
+    int historyCount;
+    int historyTail;
+    char historyLine[kConsoleHistoryLineLength];
+    int historyLength;
+    LCDBitmap *historyBitmap;
+    int historyScroll;
+    float historyCrank;
+    bool historyUpdate;
+    PDMenuItem *historyMenu;
+    bool historyMode;
+
 };
 
 // 外部参照関数
@@ -68,6 +144,7 @@ extern void ConsoleInitialize(void);
 extern void ConsoleLoad(void);
 extern void ConsolePrintText(const char *text);
 extern bool ConsoleIsPrintText(void);
+extern bool ConsoleIsPrintable(int length);
 extern void ConsoleOpenMenu(const char **items, int size);
 extern bool ConsoleIsOpenMenu(void);
 extern int ConsoleGetSelectedMenu(void);
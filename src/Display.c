@@ -60,6 +60,12 @@ void DisplayLoad(void)
         // タグの設定
         ActorSetTag(&display->actor, kGameTagDisplay);
 
+        // 更新行の設定
+        IocsMarkDirty(0, kDisplayBitmapSizeY);
+
+        // パネルの設定
+        IocsSetPanel(kGameOrderDisplay, 0, 0, kDisplayBitmapSizeX, kDisplayBitmapSizeY, true);
+
         // ビットマップの作成
         display->bitmap = playdate->graphics->newBitmap(kDisplayBitmapSizeX, kDisplayBitmapSizeY, kColorBlack);
         if (display->bitmap == NULL) {
@@ -68,6 +74,11 @@ void DisplayLoad(void)
 
         // マップの設定
         display->map = kDisplayMapNull;
+        display->printed = kDisplayMapNull;
+        display->redraw = true;
+
+        // 短距離センサの設定
+        display->sensor = GameIsShortRangeSensorAvilable();
     }
 }
 
@@ -81,6 +92,9 @@ static void DisplayUnload(struct Display *display)
         return;
     }
 
+    // パネルの解除
+    IocsResetPanel(kGameOrderDisplay);
+
     // ビットマップの解放
     if (display->bitmap != NULL) {
         playdate->graphics->freeBitmap(display->bitmap);
@@ -97,18 +111,8 @@ static void DisplayDraw(struct Display *display)
         return;
     }
 
-    // マップの描画
-    if (display->map == kDisplayMapGalaxy) {
-        GamePrintGalaxyMap(display->bitmap);
-    } else if (display->map == kDisplayMapSector && GameIsShortRangeSensorAvilable()) {
-        GamePrintSectorMap(display->bitmap);
-    } else {
-        GamePrintNoMap(display->bitmap);
-    }
-
     // ビットマップの描画
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->drawBitmap(display->bitmap, 0, 0, kBitmapUnflipped);
+    IocsDrawPanelBitmap(kGameOrderDisplay, display->bitmap, 0, 0);
 }
 
 // ディスプレイが待機する
@@ -128,6 +132,31 @@ static void DisplayLoop(struct Display *display)
         ++display->actor.state;
     }
 
+    // マップの更新（表示するマップが変わったときは全体を描き直す）
+    {
+        if (GameIsDamageUpdated()) {
+            display->sensor = GameIsShortRangeSensorAvilable();
+        }
+        DisplayMap map = display->map;
+        if (map == kDisplayMapSector && !display->sensor) {
+            map = kDisplayMapNull;
+        }
+        bool redraw = (display->redraw || map != display->printed) ? true : false;
+        bool updated = false;
+        if (map == kDisplayMapGalaxy) {
+            updated = GamePrintGalaxyMap(display->bitmap, redraw);
+        } else if (map == kDisplayMapSector) {
+            updated = GamePrintSectorMap(display->bitmap, redraw);
+        } else {
+            updated = GamePrintNoMap(display->bitmap, redraw);
+        }
+        display->printed = map;
+        display->redraw = false;
+        if (updated) {
+            IocsMarkDirty(0, kDisplayBitmapSizeY);
+        }
+    }
+
     // 描画処理の設定
     ActorSetDraw(&display->actor, (ActorFunction)DisplayDraw, kGameOrderDisplay);
 }
@@ -36,6 +36,11 @@ struct Display {
 
     // マップ
     DisplayMap map;
+    DisplayMap printed;
+    bool redraw;
+
+    // 短距離センサ（損傷が書き換えられたときだけ調べ直す）
+    bool sensor;
 
 };
 
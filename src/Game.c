@@ -4,6 +4,9 @@
 // 外部参照
 //
 #include <string.h>
+#if defined(__ARM_FEATURE_DSP)
+#include <arm_acle.h>
+#endif
 #include "pd_api.h"
 #include "Iocs.h"
 #include "Scene.h"
@@ -20,13 +23,118 @@
 static void GameUnload(struct Game *game);
 static void GameTransition(struct Game *game, GameFunction function);
 static void GameLoad(struct Game *game);
+static void GameLoadSectorSheet(struct Game *game);
 static void GamePlay(struct Game *game);
+static void GameRun(struct Game *game);
 static void GameDone(struct Game *game);
+static void GameTextClear(struct Game *game);
+static void GameTextAppend(struct Game *game, const char *string);
+static void GameTextAppendNumber(struct Game *game, int value, int width, char pad);
 static void GameBasicNext(struct Game *game);
 static void GameBasicBack(struct Game *game);
 static void GameBasicGoto(struct Game *game, int line);
 static void GameBasicGosub(struct Game *game, int line);
 static void GameBasicReturn(struct Game *game);
+static void GameBasicBuild(void);
+static void GameBasicCompile(struct Game *game);
+static void GameBasicOpenInput(struct Game *game);
+static void GameBasicCloseInput(struct Game *game);
+static const struct GameBasicInput *GameBasicFindInput(int line);
+static int GameBasicGetAt(struct Game *game, int index);
+static void GameBasicSetAt(struct Game *game, int index, int value);
+static void GameBasicTouch(struct Game *game, int region);
+static GameFunction GameBasicFind(int line);
+static int GameBasicSelectBit(uint64_t bits, int n);
+static const struct GameBasicCourse *GameBasicGetCourse(int course);
+static void GameSeedRandom(struct Game *game, uint32_t seed);
+static uint32_t GameNextRandom(struct Game *game);
+static int GameRandom(struct Game *game, int n);
+static bool GameBasicCall145(struct Game *game);
+static void GameBasicCall160(struct Game *game);
+static void GameBasicCall165(struct Game *game);
+static void GameBasicCall300(struct Game *game);
+static void GameBasicCombat(struct Game *game);
+static void GameBasicLine0(struct Game *game);
+static void GameBasicLine5(struct Game *game);
+static void GameBasicLine10(struct Game *game);
+static void GameBasicLine40(struct Game *game);
+static void GameBasicLine45(struct Game *game);
+static void GameBasicLine50(struct Game *game);
+static void GameBasicLine55(struct Game *game);
+static void GameBasicLine60(struct Game *game);
+static void GameBasicLine65(struct Game *game);
+static void GameBasicLine70(struct Game *game);
+static void GameBasicLine75(struct Game *game);
+static void GameBasicLine80(struct Game *game);
+static void GameBasicLine85(struct Game *game);
+static void GameBasicLine90(struct Game *game);
+static void GameBasicLine95(struct Game *game);
+static void GameBasicLine100(struct Game *game);
+static void GameBasicLine105(struct Game *game);
+static void GameBasicLine110(struct Game *game);
+static void GameBasicLine115(struct Game *game);
+static void GameBasicLine120(struct Game *game);
+static void GameBasicLine175(struct Game *game);
+static void GameBasicLine180(struct Game *game);
+static void GameBasicLine185(struct Game *game);
+static void GameBasicLine200(struct Game *game);
+static void GameBasicLine205(struct Game *game);
+static void GameBasicLine220(struct Game *game);
+static void GameBasicLine225(struct Game *game);
+static void GameBasicLine260(struct Game *game);
+static void GameBasicLine265(struct Game *game);
+static void GameBasicLine270(struct Game *game);
+static void GameBasicLine275(struct Game *game);
+static void GameBasicLine280(struct Game *game);
+static void GameBasicLine285(struct Game *game);
+static void GameBasicLine290(struct Game *game);
+static void GameBasicLine295(struct Game *game);
+static void GameBasicLine305(struct Game *game);
+static void GameBasicLine310(struct Game *game);
+static void GameBasicLine315(struct Game *game);
+static void GameBasicLine320(struct Game *game);
+static void GameBasicLine325(struct Game *game);
+static void GameBasicLine330(struct Game *game);
+static void GameBasicLine335(struct Game *game);
+static void GameBasicLine336(struct Game *game);
+static void GameBasicLine350(struct Game *game);
+static void GameBasicLine355(struct Game *game);
+static void GameBasicLine360(struct Game *game);
+static void GameBasicLine365(struct Game *game);
+static void GameBasicLine370(struct Game *game);
+static void GameBasicLine375(struct Game *game);
+static void GameBasicLine420(struct Game *game);
+static void GameBasicLine455(struct Game *game);
+static void GameBasicLine465(struct Game *game);
+static void GameBasicLine470(struct Game *game);
+static void GameBasicLine475(struct Game *game);
+static void GameBasicLine480(struct Game *game);
+static void GameBasicLine490(struct Game *game);
+static void GameBasicLine495(struct Game *game);
+static void GameBasicLine505(struct Game *game);
+static void GameBasicLine520(struct Game *game);
+static void GameBasicLine525(struct Game *game);
+static void GameBasicLine530(struct Game *game);
+static void GameBasicLine535(struct Game *game);
+static void GameBasicLine540(struct Game *game);
+static void GameBasicLine545(struct Game *game);
+static void GameBasicLine555(struct Game *game);
+static void GameBasicLine560(struct Game *game);
+static void GameBasicLine565(struct Game *game);
+static void GameBasicLine570(struct Game *game);
+static void GameBasicLine575(struct Game *game);
+static void GameBasicLine585(struct Game *game);
+static void GameBasicLine590(struct Game *game);
+static void GameBasicLine595(struct Game *game);
+static void GameBasicLine600(struct Game *game);
+static void GameBasicLine605(struct Game *game);
+static void GameBasicLine610(struct Game *game);
+static void GameBasicLine615(struct Game *game);
+static void GameBasicLine620(struct Game *game);
+static void GameBasicLine625(struct Game *game);
+static void GameBasicLine630(struct Game *game);
+static void GameBasicLine635(struct Game *game);
+static void GameBasicLine640(struct Game *game);
 
 // 内部変数
 //
@@ -37,6 +145,137 @@ static const char *gameAudioSamplePaths[] = {
     "", 
 };
 static const char *gameAudioMusicPath = "";
+// BASIC の行の表
+// res/basic/tinytrek.bas を手で移植した行の関数を並べる、クラシックでは .bas を翻訳して仮想機械で実行する
+// 計算で決まる G. / GOS. の飛び先もこの表から引く
+//
+static const struct GameBasicLine gameBasicLines[] = {
+    {  0, (GameFunction)GameBasicLine0, }, 
+    {  5, (GameFunction)GameBasicLine5, }, 
+    { 10, (GameFunction)GameBasicLine10, }, 
+    { 40, (GameFunction)GameBasicLine40, }, 
+    { 45, (GameFunction)GameBasicLine45, }, 
+    { 50, (GameFunction)GameBasicLine50, }, 
+    { 55, (GameFunction)GameBasicLine55, }, 
+    { 60, (GameFunction)GameBasicLine60, }, 
+    { 65, (GameFunction)GameBasicLine65, }, 
+    { 70, (GameFunction)GameBasicLine70, }, 
+    { 75, (GameFunction)GameBasicLine75, }, 
+    { 80, (GameFunction)GameBasicLine80, }, 
+    { 85, (GameFunction)GameBasicLine85, }, 
+    { 90, (GameFunction)GameBasicLine90, }, 
+    { 95, (GameFunction)GameBasicLine95, }, 
+    {100, (GameFunction)GameBasicLine100, }, 
+    {105, (GameFunction)GameBasicLine105, }, 
+    {110, (GameFunction)GameBasicLine110, }, 
+    {115, (GameFunction)GameBasicLine115, }, 
+    {120, (GameFunction)GameBasicLine120, }, 
+    {175, (GameFunction)GameBasicLine175, }, 
+    {180, (GameFunction)GameBasicLine180, }, 
+    {185, (GameFunction)GameBasicLine185, }, 
+    {200, (GameFunction)GameBasicLine200, }, 
+    {205, (GameFunction)GameBasicLine205, }, 
+    {220, (GameFunction)GameBasicLine220, }, 
+    {225, (GameFunction)GameBasicLine225, }, 
+    {260, (GameFunction)GameBasicLine260, }, 
+    {265, (GameFunction)GameBasicLine265, }, 
+    {270, (GameFunction)GameBasicLine270, }, 
+    {275, (GameFunction)GameBasicLine275, }, 
+    {280, (GameFunction)GameBasicLine280, }, 
+    {285, (GameFunction)GameBasicLine285, }, 
+    {290, (GameFunction)GameBasicLine290, }, 
+    {295, (GameFunction)GameBasicLine295, }, 
+    {305, (GameFunction)GameBasicLine305, }, 
+    {310, (GameFunction)GameBasicLine310, }, 
+    {315, (GameFunction)GameBasicLine315, }, 
+    {320, (GameFunction)GameBasicLine320, }, 
+    {325, (GameFunction)GameBasicLine325, }, 
+    {330, (GameFunction)GameBasicLine330, }, 
+    {335, (GameFunction)GameBasicLine335, }, 
+    {336, (GameFunction)GameBasicLine336, }, 
+    {350, (GameFunction)GameBasicLine350, }, 
+    {355, (GameFunction)GameBasicLine355, }, 
+    {360, (GameFunction)GameBasicLine360, }, 
+    {365, (GameFunction)GameBasicLine365, }, 
+    {370, (GameFunction)GameBasicLine370, }, 
+    {375, (GameFunction)GameBasicLine375, }, 
+    {420, (GameFunction)GameBasicLine420, }, 
+    {455, (GameFunction)GameBasicLine455, }, 
+    {465, (GameFunction)GameBasicLine465, }, 
+    {470, (GameFunction)GameBasicLine470, }, 
+    {475, (GameFunction)GameBasicLine475, }, 
+    {480, (GameFunction)GameBasicLine480, }, 
+    {490, (GameFunction)GameBasicLine490, }, 
+    {495, (GameFunction)GameBasicLine495, }, 
+    {505, (GameFunction)GameBasicLine505, }, 
+    {520, (GameFunction)GameBasicLine520, }, 
+    {525, (GameFunction)GameBasicLine525, }, 
+    {530, (GameFunction)GameBasicLine530, }, 
+    {535, (GameFunction)GameBasicLine535, }, 
+    {540, (GameFunction)GameBasicLine540, }, 
+    {545, (GameFunction)GameBasicLine545, }, 
+    {555, (GameFunction)GameBasicLine555, }, 
+    {560, (GameFunction)GameBasicLine560, }, 
+    {565, (GameFunction)GameBasicLine565, }, 
+    {570, (GameFunction)GameBasicLine570, }, 
+    {575, (GameFunction)GameBasicLine575, }, 
+    {585, (GameFunction)GameBasicLine585, }, 
+    {590, (GameFunction)GameBasicLine590, }, 
+    {595, (GameFunction)GameBasicLine595, }, 
+    {600, (GameFunction)GameBasicLine600, }, 
+    {605, (GameFunction)GameBasicLine605, }, 
+    {610, (GameFunction)GameBasicLine610, }, 
+    {615, (GameFunction)GameBasicLine615, }, 
+    {620, (GameFunction)GameBasicLine620, }, 
+    {625, (GameFunction)GameBasicLine625, }, 
+    {630, (GameFunction)GameBasicLine630, }, 
+    {635, (GameFunction)GameBasicLine635, }, 
+    {640, (GameFunction)GameBasicLine640, }, 
+};
+static GameFunction gameBasicFunctions[kGameBasicLineSize];
+
+// クラシックで実行する BASIC のプログラム
+static const char *gameBasicProgramPath = "basic/tinytrek.bas";
+
+// クラシックの IN. の入力（メニューの項目は打ち込む英字の変数の値になる）
+static const char *gameBasicYesNoItems[] = {
+    "NO", 
+    "YES", 
+};
+static const char *gameBasicCommandItems[] = {
+    "REPORT", 
+    "SHORT RANGE SENSOR", 
+    "LONG RANGE SENSOR", 
+    "GALAXY MAP", 
+    "PHASER", 
+    "TORPEDO", 
+    "WARP ENGINE", 
+};
+static const struct GameBasicInput gameBasicInputs[] = {
+    {  5, kGameBasicInputMenu, gameBasicYesNoItems, "NY", 2, 0, 0, }, 
+    {110, kGameBasicInputMenu, gameBasicYesNoItems, "NY", 2, 0, 0, }, 
+    {120, kGameBasicInputMenu, gameBasicCommandItems, "RSLGPTW", 7, 0, 0, }, 
+    {265, kGameBasicInputNumber, NULL, NULL, 0, 0, 9999, }, 
+    {470, kGameBasicInputNumber, NULL, NULL, 0, 0, 99, }, 
+    {615, kGameBasicInputAngle, NULL, NULL, 0, 0, 360, }, 
+};
+static const struct GameBasicInput gameBasicInputDefault = {
+    0, kGameBasicInputNumber, NULL, NULL, 0, 0, 9999, 
+};
+
+// BASIC のエラー
+static const char *gameBasicErrors[] = {
+    "", 
+    "WHAT?", 
+    "HOW?", 
+    "SORRY", 
+};
+
+// セクタの近傍
+static uint64_t gameBasicSectorNeighbours[kGameBasicSectorSize];
+
+// コースの軌跡
+static struct GameBasicCourse gameBasicCourses[kGameBasicCourseSize];
 
 
 // ゲームを更新する
@@ -70,6 +309,16 @@ void GameUpdate(struct Game *game)
 
             // クラシックの設定
             game->classic = true;
+
+            // BASIC の実行数の設定
+            game->basicStep = kGameBasicStepDefault;
+
+            // 乱数の設定（GAME_RANDOM_SEED が定義されていれば同じ種で再現する）
+#if defined(GAME_RANDOM_SEED)
+            GameSeedRandom(game, GAME_RANDOM_SEED);
+#else
+            GameSeedRandom(game, playdate->system->getSecondsSinceEpoch(NULL));
+#endif
         }
 
         // スプライトの読み込み
@@ -78,6 +327,12 @@ void GameUpdate(struct Game *game)
         // オーディオの読み込み
         // IocsLoadAudioEffects(gameAudioSamplePaths, kGameAudioSampleSize);
 
+        // BASIC の行の作成
+        GameBasicBuild();
+
+        // BASIC のプログラムの翻訳
+        GameBasicCompile(game);
+
         // コンソールの初期化
         ConsoleInitialize();
 
@@ -101,9 +356,27 @@ void GameUpdate(struct Game *game)
 //
 static void GameUnload(struct Game *game)
 {
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
     // アクタの解放
     ActorUnloadAll();
 
+    // BASIC のプログラムの解放
+    if (game->program != NULL) {
+        playdate->system->realloc(game->program, 0);
+        game->program = NULL;
+    }
+
+    // セクター地図のタイルの解放
+    if (game->sectorSheet != NULL) {
+        playdate->graphics->freeBitmap(game->sectorSheet);
+        game->sectorSheet = NULL;
+    }
+
     // スプライトの解放
     AsepriteUnloadAllSprites();
 
@@ -135,6 +408,12 @@ static void GameLoad(struct Game *game)
         //コンソールの読み込み
         ConsoleLoad();
 
+        // セクター地図のタイルの作成
+        GameLoadSectorSheet(game);
+
+        // 画面全体の再描画
+        IocsMarkDirtyAll();
+
         // 初期化の完了
         ++game->state;
     }
@@ -143,6 +422,49 @@ static void GameLoad(struct Game *game)
     GameTransition(game, (GameFunction)GamePlay);
 }
 
+// セクター地図のタイルを作成する（1 マス分の幅で背景ごと 5 種類を横に並べる）
+//
+static void GameLoadSectorSheet(struct Game *game)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 作成済み
+    if (game->sectorSheet != NULL) {
+        return;
+    }
+
+    // 大きさの取得
+    int width = 2 * IocsGetTextWidth(kIocsFontJapanese, "9");
+    int height = IocsGetFontHeight(kIocsFontJapanese);
+
+    // ビットマップの作成
+    game->sectorSheet = playdate->graphics->newBitmap(kGameBasicSectorTypeSize * width, height, kColorBlack);
+    if (game->sectorSheet == NULL) {
+        playdate->system->error("%s: %d: sector sheet is not created.", __FILE__, __LINE__);
+        return;
+    }
+
+    // タイルの描画
+    static const char *texts[] = {
+        ".", 
+        "K", 
+        "B", 
+        "*", 
+        "E", 
+    };
+    playdate->graphics->pushContext(game->sectorSheet);
+    IocsSetFont(kIocsFontJapanese);
+    playdate->graphics->setDrawMode(kDrawModeFillWhite);
+    for (int i = 0; i < kGameBasicSectorTypeSize; i++) {
+        playdate->graphics->drawText(texts[i], strlen(texts[i]), kUTF8Encoding, i * width, 0);
+    }
+    playdate->graphics->popContext();
+}
+
 // ゲームをプレイする
 //
 static void GamePlay(struct Game *game)
@@ -163,1412 +485,1799 @@ static void GamePlay(struct Game *game)
         ++game->state;
     }
 
-    // テキストを表示している
-    if (ConsoleIsPrintText()) {
-        ;
-
-    // メニューが開かれている
-    } else if (ConsoleIsOpenMenu()) {
-        ;
-    
-    // 数値が入力されている
-    } else if (ConsoleIsInputNumber()) {
-        ;
-    
-    // 角度が入力されている
-    } else if (ConsoleIsInputAngle()) {
-        ;
-    
     // BASIC の実行
-    } else {
-
-        // 0 
-        if (game->basic.run.line == 0) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("DO YOU PLAY A CLASSIC GAME? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                static const char *items[] = {
-                    "NO", 
-                    "YES", 
-                };
-                ConsoleOpenMenu(items, 2);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                if (ConsoleGetSelectedMenu() == 0) {
-                    DisplayLoad();
-                    ReportLoad();
-                    game->classic = false;
-                } else {
-                    game->classic = true;
-                }
-                GameBasicGoto(game, 5);
-            }
+    for (int step = 0; step < game->basicStep; step++) {
 
-        // 5 Y=2999;IN."DO YOU WANT A DIFFICULT GAME?  ","(Y OR N)"A
-        } else if (game->basic.run.line == 5) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.Y = 2999;
-                ConsolePrintText("DO YOU WANT A DIFFICULT GAME? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                static const char *items[] = {
-                    "NO", 
-                    "YES", 
-                };
-                ConsoleOpenMenu(items, 2);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.A = ConsoleGetSelectedMenu();
-                GameBasicGoto(game, 10);
-            }
+        // 出力キューに空きがない
+        if (!ConsoleIsPrintable(kGameTextSize)) {
+            break;
 
-        // 10 PR."STARDATE 3200:  YOUR MISSION IS ",;IFA=YY=999
-        // 15 K=0,B=0,D=30;F.I=0TO63;J=R.(99)<5,B=B+J
-        // 20 M=R.(Y),M=(M<209)+(M<99)+(M<49)+(M<24)+(M<9)+(M<2),K=K+M
-        // 25 @(I)=-100*M-10*J-R.(8);N.I;IF(B<2)+(K<4)G.15
-        // 30 PR."TO DESTROY ",#1,K," KLINGONS IN 30 STARDATES.
-        // 35 PR."THERE ARE ",#1,B," STARBASES.";GOS.160;C=0,H=K
-        } else if (game->basic.run.line == 10) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.A == 1) {
-                    game->basic.Y = 999;
-                }
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.K = 0;
-                game->basic.B = 0;
-                game->basic.D = 30;
-                for (game->basic.I = 0; game->basic.I <= 63; game->basic.I++) {
-                    game->basic.J = (rand() % 99 + 1) < 5 ? 1 : 0;
-                    game->basic.B = game->basic.B + game->basic.J;
-                    game->basic.M = (rand() % game->basic.Y + 1);
-                    game->basic.M 
-                        = (game->basic.M < 209 ? 1 : 0) 
-                        + (game->basic.M < 99 ? 1 : 0) 
-                        + (game->basic.M < 49 ? 1 : 0) 
-                        + (game->basic.M < 24 ? 1 : 0) 
-                        + (game->basic.M < 9 ? 1 : 0)
-                        + (game->basic.M < 2 ? 1 : 0);
-                    game->basic.K = game->basic.K + game->basic.M;
-                    game->basic.at[game->basic.I] = -100 * game->basic.M - 10 * game->basic.J - (rand() % 8 + 1);
-                }
-                if (game->basic.B < 2 || game->basic.K < 4) {
-                    ;
-                } else {
-                    char *text;
-                    playdate->system->formatString(&text, "STARDATE 3200: YOUR MISSION IS TO DESTROY %d KLINGONS IN 30 STARDATES. THERE ARE %d STARBASES.\n", game->basic.K, game->basic.B);
-                    strcpy(game->text, text);
-                    playdate->system->realloc(text, 0);
-                    ConsolePrintText(game->text);
-                    GameBasicGosub(game, 160);
-                }
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.C = 0;
-                game->basic.H = game->basic.K;
-                GameBasicGoto(game, 40);
-            }
-        
-        // 40 U=R.(8),V=R.(8),X=R.(8),Y=R.(8)
-        } else if (game->basic.run.line == 40) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.U = rand() % 8 + 1;
-                game->basic.V = rand() % 8 + 1;
-                game->basic.X = rand() % 8 + 1;
-                game->basic.Y = rand() % 8 + 1;
-                GameBasicGoto(game, 45);
-            }
+        // メニューが開かれている
+        } else if (ConsoleIsOpenMenu()) {
+            break;
 
-        // 45 F.I=71TO152;@(I)=0;N.I;@(8*X+Y+62)=4,M=A.(@(8*U+V-9)),N=M/100
-        } else if (game->basic.run.line == 45) {
-            if (game->basic.run.sentence == 0) {
-                for (game->basic.I = 71; game->basic.I <= 152; game->basic.I++) {
-                    game->basic.at[game->basic.I] = 0;
-                }
-                game->basic.at[8 * game->basic.X + game->basic.Y + 62] = 4;
-                game->basic.M = abs(game->basic.at[8 * game->basic.U + game->basic.V - 9]);
-                game->basic.N = game->basic.M / 100;
-                GameBasicGoto(game, 50);
-            }
+        // 数値が入力されている
+        } else if (ConsoleIsInputNumber()) {
+            break;
 
-        // 50 I=1;IFNF.J=1TON;GOS.165;@(J+134)=300,@(J+140)=S,@(J+146)=T;N.J
-        } else if (game->basic.run.line == 50) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.I = 1;
-                if (game->basic.N != 0) {
-                    game->basic.J = 1;
-                    GameBasicNext(game);
-                } else {
-                    GameBasicGoto(game, 55);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                GameBasicGosub(game, 165);
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.at[game->basic.J + 134] = 300;
-                game->basic.at[game->basic.J + 140] = game->basic.S;
-                game->basic.at[game->basic.J + 146] = game->basic.T;
-                ++game->basic.J;
-                if (game->basic.J <= game->basic.N) {
-                    GameBasicBack(game);
-                } else {
-                    GameBasicGoto(game, 55);
-                }
-            }
+        // 角度が入力されている
+        } else if (ConsoleIsInputAngle()) {
+            break;
+        }
 
-        // 55 GOS.175;M=M-100*N,I=2;IFM/10GOS.165
-        } else if (game->basic.run.line == 55) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 175);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.M = game->basic.M - 100 * game->basic.N;
-                game->basic.I = 2;
-                if (game->basic.M / 10 != 0) {
-                    GameBasicGosub(game, 165);
-                } else {
-                    GameBasicGoto(game, 60);
-                }
-            } else if (game->basic.run.sentence == 2) {
-                GameBasicGoto(game, 60);
-            }
+        // 行の実行
+        GameFunction function = GameBasicFind(game->basic.run.line);
+        if (function != NULL) {
+            int line = game->basic.run.line;
+            int sentence = game->basic.run.sentence;
+            (*function)(game);
 
-        // 60 M=M-M/10*10,I=3;IFMF.J=1TOM;GOS.165;N.J
-        } else if (game->basic.run.line == 60) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.M = game->basic.M - game->basic.M / 10 * 10;
-                game->basic.I = 3;
-                if (game->basic.M != 0) {
-                    game->basic.J = 1;
-                    GameBasicNext(game);
-                } else {
-                    GameBasicGoto(game, 65);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                GameBasicGosub(game, 165);
-            } else if (game->basic.run.sentence == 2) {
-                ++game->basic.J;
-                if (game->basic.J <= game->basic.M) {
-                    GameBasicBack(game);
-                } else {
-                    GameBasicGoto(game, 65);
-                }
-            }
+            // 処理が遷移した
+            if (game->function != (GameFunction)GamePlay) {
+                break;
 
-        // 65 GOS.145;GOS.325;IFKG.95
-        } else if (game->basic.run.line == 65) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 145);
-            } else if (game->basic.run.sentence == 1) {
-                GameBasicGosub(game, 325);
-            } else if (game->basic.run.sentence == 2) {
-                if (game->basic.K != 0) {
-                    GameBasicGoto(game, 95);
-                } else {
-                    GameBasicGoto(game, 70);
-                }
+            // 実行位置が進まない（停止中）
+            } else if (game->basic.run.line == line && game->basic.run.sentence == sentence) {
+                break;
             }
+        } else {
+            playdate->system->error("%s: %d: illegal basic line: %d.", __FILE__, __LINE__, game->basic.run.line);
+            break;
+        }
+    }
+}
 
-        // 70 PR.;PR."MISSION ACCOMPLISHED.";IFD<3PR."BOY, YOU BARELY MADE IT. 
-        } else if (game->basic.run.line == 70) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("\nMISSION ACCOMPLISHED.\n");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.D < 3) {
-                    ConsolePrintText("BOY, YOU BARELY MADE IT.\n");
-                }
-                GameBasicGoto(game, 75);
-            }
+// クラシックのゲームを仮想機械で実行する
+//
+static void GameRun(struct Game *game)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
 
-        // 75 IFD>5PR."GOOD WORK...";IFD>9PR."FANTASTIC!";IFD>13PR."UNBELIEVABLE!
-        } else if (game->basic.run.line == 75) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.D > 5) {
-                    ConsolePrintText("GOOD WORK...\n");
-                    GameBasicNext(game);
-                } else {
-                    GameBasicGoto(game, 80);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.D > 9) {
-                    ConsolePrintText("FANTASTIC!\n");
-                    GameBasicNext(game);
-                } else {
-                    GameBasicGoto(game, 80);
-                }
-            } else if (game->basic.run.sentence ==2) {
-                if (game->basic.D > 13) {
-                    ConsolePrintText("UNBELIEVABLE!\n");
-                }
-                GameBasicGoto(game, 80);
-            }
+    // 初期化
+    if (game->state == 0) {
 
-        // 80 D=30-D,I=H*100/D*10;PR.#1,H," KLINGONS IN ",D," STARDATES. (",I,")
-        } else if (game->basic.run.line == 80) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.D = 30 - game->basic.D;
-                game->basic.I = game->basic.H * 100 / game->basic.D * 10;
-                char *text;
-                playdate->system->formatString(&text, "%d KLINGONS IN %d STARDATES. (%d)\n", game->basic.H, game->basic.D, game->basic.I);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 85);
-            }
+        // 仮想機械の設定
+        BasicStart(&game->machine, game->program, &game->basic, (BasicRandom)GameRandom, game);
 
-        // 85 J=100*(C=0)-5*C;PR.#1,C," CASUALTIES INCURRED. (",J,")
-        } else if (game->basic.run.line == 85) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = 100 * (game->basic.C == 0 ? 1 : 0) - 5 * game->basic.C;
-                char *text;
-                playdate->system->formatString(&text, "%d CASUALTIES INCURRED. (%d)\n", game->basic.C, game->basic.J);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 90);
-            }
+        // 初期化の完了
+        ++game->state;
+    }
 
-        // 90 PR."YOUR SCORE:",I+J;G.110
-        } else if (game->basic.run.line == 90) {
-            if (game->basic.run.sentence == 0) {
-                char *text;
-                playdate->system->formatString(&text, "YOUR SCORE: %d\n", game->basic.I + game->basic.J);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 110);
-            }
+    // BASIC の実行
+    if (game->state == 1) {
 
-        // 95 IFD<0PR."IT'S TOO LATE, THE FEDERATION HAS BEEN CONQUERED.";G.110
-        } else if (game->basic.run.line == 95) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.D < 0) {
-                    ConsolePrintText("IT'S TOO LATE, THE FEDERATION HAS BEEN CONQUERED.n");
-                    GameBasicGoto(game, 110);
-                } else {
-                    GameBasicGoto(game, 100);
-                }
-            }
+        // 出力キューに空きがない
+        if (!ConsoleIsPrintable(kBasicTextSize)) {
+            return;
 
-        // 100 IFE>=0G.120
-        } else if (game->basic.run.line == 100) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.E >= 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 105);
-                }
-            }
+        // 入力の途中
+        } else if (ConsoleIsOpenMenu() || ConsoleIsInputNumber() || ConsoleIsInputAngle()) {
+            return;
+        }
 
-        // 105 PR."ENTERPRISE DESTROYED";IFH-K>9PR."BUT YOU WERE A GOOD MAN
-        } else if (game->basic.run.line == 105) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("ENTERPRISE DESTROYED\n");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.H - game->basic.K > 9) {
-                    ConsolePrintText("BUT YOU WERE A GOOD MAN\n");
-                }
-                GameBasicGoto(game, 110);
-            }
+        // 入力の完了
+        if (game->machine.input >= 0) {
+            GameBasicCloseInput(game);
+        }
 
-        // 110 Y=987;PR.;IN."ANOTHERE GAME?  ","(Y OR N)"A;IFA=YG.5
-        } else if (game->basic.run.line == 110) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("\nANOTHERE GAME? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                static const char *items[] = {
-                    "NO", 
-                    "YES", 
-                };
-                ConsoleOpenMenu(items, 2);
-                GameBasicNext(game);
-            } else {
-                game->basic.A = ConsoleGetSelectedMenu();
-                if (game->basic.A == 1) {
-                    GameBasicGoto(game, 5);
-                } else {
-                    GameBasicGoto(game, 115);
-                }
-            }
+        // 仮想機械の実行
+        int result = BasicRun(&game->machine, &game->basic, kGameBasicMachineStep);
 
-        // 115 PR."GOOD BYE.";STOP
-        } else if (game->basic.run.line == 115) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("GOOD BYE.");
-                GameBasicNext(game);
-            } else {
-                ;
-            }
-        
-        // 120 S=220,G=180,L=200,P=260,R=420,W=465,T=555;IN."CAPTAIN"A
-        // 125 IF(A=S)+(A=G)+(A=L)+(A=P)+(A=R)+(A=W)+(A=T)G.A
-        // 130 PR."R=REPORT       S=SR. SENSOR   L=LR. SENSOR
-        // 135 PR."G=GALAXY MAP   P=PHASER       T=TORPEDO
-        // 140 PR."W=WARP ENGINE  **PLEASE USE ONE OF THESE COMMANDS***";G.120
-        } else if (game->basic.run.line == 120) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("CAPTAIN? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                static const char *items[] = {
-                    "REPORT", 
-                    "SHORT RANGE SENSOR", 
-                    "LONG RANGE SENSOR", 
-                    "GALAXY MAP", 
-                    "PHASER", 
-                    "TORPEDO", 
-                    "WARP ENGINE"
-                };
-                ConsoleOpenMenu(items, 7);
-                GameBasicNext(game);
-            } else {
-                game->basic.A = ConsoleGetSelectedMenu();
-                // 120 S=220,G=180,L=200,P=260,R=420,W=465,T=555;IN."CAPTAIN"A
-                if (game->basic.A == 0) {
-                    GameBasicGoto(game, 420);
-                } else if (game->basic.A == 1) {
-                    GameBasicGoto(game, 220);
-                } else if (game->basic.A == 2) {
-                    GameBasicGoto(game, 200);
-                } else if (game->basic.A == 3) {
-                    GameBasicGoto(game, 180);
-                } else if (game->basic.A == 4) {
-                    GameBasicGoto(game, 260);
-                } else if (game->basic.A == 5) {
-                    GameBasicGoto(game, 555);
-                } else if (game->basic.A == 6) {
-                    GameBasicGoto(game, 465);
-                }
-            }
-        
-        // 145 F.I=X-(X>1)TOX+(X<8);F.J=Y-(Y>1)TOY+(Y<8)
-        // 150 IF@(8*I+J+62)#2N.J;N.I;O=0;R.
-        } else if (game->basic.run.line == 145) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.I = game->basic.X - (game->basic.X > 1 ? 1 : 0);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.J = game->basic.Y - (game->basic.Y > 1 ? 1 : 0);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                if (game->basic.at[8 * game->basic.I + game->basic.J + 62] != 2) {
-                    ++game->basic.J;
-                    if (game->basic.J <= game->basic.Y + (game->basic.Y < 8 ? 1 : 0)) {
-                        ;
-                    } else {
-                        ++game->basic.I;
-                        if (game->basic.I <= game->basic.X + (game->basic.X < 8 ? 1 : 0)) {
-                            GameBasicBack(game);
-                        } else {
-                            game->basic.O = 0;
-                            GameBasicReturn(game);
-                        }
-                    }
-                } else {
-                    GameBasicGoto(game, 155);
-                }
-            }
-        
-        // 155 IFO=0PR.'SULU: "CAPTAIN, WE ARE DOCKED AT STARBASE."
-        } else if (game->basic.run.line == 155) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.O == 0) {
-                    ConsolePrintText("SULU: \"CAPTAIN, WE ARE DOCKED AT STARBASE.\"\n");
-                }
-                GameBasicGoto(game, 160);
-            }
+        // 出力
+        if (game->machine.textLength > 0) {
+            ConsolePrintText(game->machine.text);
+        }
 
-        // 160 E=4000,F=10,O=1;F.I=64TO70;@(I)=0;N.I;R.
-        } else if (game->basic.run.line == 160) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.E = 4000;
-                game->basic.F = 10;
-                game->basic.O = 1;
-                for (game->basic.I = 64; game->basic.I <= 70; game->basic.I++) {
-                    game->basic.at[game->basic.I] = 0;
-                }
-                GameBasicReturn(game);
-            }
+        // 入力の開始
+        if (result == kBasicResultInput) {
+            GameBasicOpenInput(game);
+
+        // 停止
+        } else if (result == kBasicResultStop) {
+            ++game->state;
+
+        // エラー
+        } else if (result == kBasicResultError) {
+            GameTextClear(game);
+            GameTextAppend(game, "\n");
+            GameTextAppend(game, gameBasicErrors[game->machine.error]);
+            GameTextAppend(game, " ");
+            GameTextAppendNumber(game, game->basic.run.line, 0, ' ');
+            GameTextAppend(game, "\n");
+            ConsolePrintText(game->text);
+            ++game->state;
+        }
+    }
+}
 
-        // 165 S=R.(8),T=R.(8),A=8*S+T+62;IF@(A)G.165
-        // 170 @(A)=I;R.
-        } else if (game->basic.run.line == 165) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.S = rand() % 8 + 1;
-                game->basic.T = rand() % 8 + 1;
-                game->basic.A = 8 * game->basic.S + game->basic.T + 62;
-                if (game->basic.at[game->basic.A] != 0) {
-                    ;
-                } else {
-                    GameBasicNext(game);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.at[game->basic.A] = game->basic.I;
-                GameBasicReturn(game);
-            }
+// 0
+//
+static void GameBasicLine0(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("DO YOU PLAY A CLASSIC GAME? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        static const char *items[] = {
+            "NO", 
+            "YES", 
+        };
+        ConsoleOpenMenu(items, 2);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 2) {
+        if (ConsoleGetSelectedMenu() == 0) {
+            DisplayLoad();
+            ReportLoad();
+            game->classic = false;
+            GameBasicGoto(game, 5);
+        } else {
+            game->classic = true;
+            GameTransition(game, (GameFunction)GameRun);
+        }
+    }
+}
 
-        // 175 PR."ENTERPRISE IN Q-",#1,U,V," S-",X,Y;R.
-        } else if (game->basic.run.line == 175) {
-            if (game->basic.run.sentence == 0) {
-                char *text;
-                playdate->system->formatString(&text, "ENTERPRISE IN Q-%d%d S-%d%d\n", game->basic.U, game->basic.V, game->basic.X, game->basic.Y);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                GameBasicReturn(game);
-            }
+// 5 Y=2999;IN."DO YOU WANT A DIFFICULT GAME?  ","(Y OR N)"A
+//
+static void GameBasicLine5(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.Y = 2999;
+        ConsolePrintText("DO YOU WANT A DIFFICULT GAME? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        static const char *items[] = {
+            "NO", 
+            "YES", 
+        };
+        ConsoleOpenMenu(items, 2);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 2) {
+        game->basic.A = ConsoleGetSelectedMenu();
+        GameBasicGoto(game, 10);
+    }
+}
 
-        // 180 GOS.175;J=2;GOS.375;IFIG.120
-        } else if (game->basic.run.line == 180) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 175);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.J = 2;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 2) {
-                if (!game->classic) {
-                    DisplaySetMap(kDisplayMapGalaxy);
-                }
-                if (game->basic.I != 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 185);
-                }
-            }
+// 10 PR."STARDATE 3200:  YOUR MISSION IS ",;IFA=YY=999
+// 15 K=0,B=0,D=30;F.I=0TO63;J=R.(99)<5,B=B+J
+// 20 M=R.(Y),M=(M<209)+(M<99)+(M<49)+(M<24)+(M<9)+(M<2),K=K+M
+// 25 @(I)=-100*M-10*J-R.(8);N.I;IF(B<2)+(K<4)G.15
+// 30 PR."TO DESTROY ",#1,K," KLINGONS IN 30 STARDATES.
+// 35 PR."THERE ARE ",#1,B," STARBASES.";GOS.160;C=0,H=K
+//
+static void GameBasicLine10(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.A == 1) {
+            game->basic.Y = 999;
+        }
+        do {
+            game->basic.K = 0;
+            game->basic.B = 0;
+            game->basic.D = 30;
+            for (game->basic.I = 0; game->basic.I <= 63; game->basic.I++) {
+                game->basic.J = GameRandom(game, 99) < 5 ? 1 : 0;
+                game->basic.B = game->basic.B + game->basic.J;
+                game->basic.M = GameRandom(game, game->basic.Y);
+                game->basic.M 
+                    = (game->basic.M < 209 ? 1 : 0) 
+                    + (game->basic.M < 99 ? 1 : 0) 
+                    + (game->basic.M < 49 ? 1 : 0) 
+                    + (game->basic.M < 24 ? 1 : 0) 
+                    + (game->basic.M < 9 ? 1 : 0)
+                    + (game->basic.M < 2 ? 1 : 0);
+                game->basic.K = game->basic.K + game->basic.M;
+                GameBasicSetAt(game, game->basic.I, -100 * game->basic.M - 10 * game->basic.J - GameRandom(game, 8));
+            }
+        } while (game->basic.B < 2 || game->basic.K < 4);
+        GameBasicTouch(game, kGameVersionStatus);
+        GameTextClear(game);
+        GameTextAppend(game, "STARDATE 3200: YOUR MISSION IS TO DESTROY ");
+        GameTextAppendNumber(game, game->basic.K, 0, ' ');
+        GameTextAppend(game, " KLINGONS IN 30 STARDATES. THERE ARE ");
+        GameTextAppendNumber(game, game->basic.B, 0, ' ');
+        GameTextAppend(game, " STARBASES.\n");
+        ConsolePrintText(game->text);
+        GameBasicCall160(game);
+        game->basic.C = 0;
+        game->basic.H = game->basic.K;
+        GameBasicGoto(game, 40);
+    }
+}
 
-        // 185 PR." OF GALAXY MAP";F.I=0TO7;PR.;PR.#1,I+1,":",;F.J=0TO7;M=@(8*I+J)
-        // 190 PR.#4,(M>0)*M,;N.J;PR.;N.I;PR."  ",;F.I=0TO7;PR."  ..",;N.I;PR.
-        // 195 PR."  ",;F.I=1TO8;PR.#4,I,;N.I;PR.;PR.;G.120
-        } else if (game->basic.run.line == 185) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText(" OF GALAXY MAP\n\n");
-                game->text[0] = '\0';
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                for (game->basic.I = 0; game->basic.I <= 7; game->basic.I++) {
-                    {
-                        char *text;
-                        playdate->system->formatString(&text, "%d:", game->basic.I + 1);
-                        strcat(game->text, text);
-                        playdate->system->realloc(text, 0);
-                    }
-                    for (game->basic.J = 0; game->basic.J <= 7; game->basic.J++) {
-                        game->basic.M = game->basic.at[8 * game->basic.I + game->basic.J];
-                        {
-                            char *text;
-                            playdate->system->formatString(&text, " %03d", (game->basic.M > 0 ? 1 : 0) * game->basic.M);
-                            strcat(game->text, text);
-                            playdate->system->realloc(text, 0);
-                        }
-                    }
-                    strcat(game->text, "\n");
-                }
-                strcat(game->text, "  ");
-                for (game->basic.I = 0; game->basic.I <= 7; game->basic.I++) {
-                    strcat(game->text, "  ..");
-                }
-                strcat(game->text, "\n");
-                strcat(game->text, "  ");
-                for (game->basic.I = 1; game->basic.I <= 8; game->basic.I++) {
-                    char *text;
-                    playdate->system->formatString(&text, "% 4d", game->basic.I);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                }
-                strcat(game->text, "\n\n");
-                if (game->classic) {
-                    ConsolePrintText(game->text);
-                }
-                GameBasicGoto(game, 120);
-            }
 
-        // 200 GOS.175;J=3;GOS.375;IFIG.120
-        } else if (game->basic.run.line == 200) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 175);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.J = 3;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 2) {
-                if (!game->classic) {
-                    DisplaySetMap(kDisplayMapGalaxy);
-                }
-                if (game->basic.I != 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 205);
-                }
-            }
+// 40 U=R.(8),V=R.(8),X=R.(8),Y=R.(8)
+//
+static void GameBasicLine40(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.U = GameRandom(game, 8);
+        game->basic.V = GameRandom(game, 8);
+        GameBasicTouch(game, kGameVersionGalaxy);
+        game->basic.X = GameRandom(game, 8);
+        game->basic.Y = GameRandom(game, 8);
+        GameBasicGoto(game, 45);
+    }
+}
 
-        // 205 PR.;F.I=U-1TOU+1;F.J=V-1TOV+1;M=8*I+J-9,A=0
-        // 210 IF(I>0)*(I<9)*(J>0)*(J<9)A=A.(@(M)),@(M)=A
-        // 215 PR.#4,A,;N.J;PR.;N.I;G.120
-        } else if (game->basic.run.line == 205) {
-            if (game->basic.run.sentence == 0) {
-                strcpy(game->text, "\n");
-                for (game->basic.I = game->basic.U - 1; game->basic.I <= game->basic.U + 1; game->basic.I++) {
-                    for (game->basic.J = game->basic.V - 1; game->basic.J <= game->basic.V + 1; game->basic.J++) {
-                        game->basic.M = 8 * game->basic.I + game->basic.J - 9;
-                        game->basic.A = 0;
-                        if (game->basic.I > 0 && game->basic.I < 9 && game->basic.J > 0 && game->basic.J < 9) {
-                            game->basic.A = abs(game->basic.at[game->basic.M]);
-                            game->basic.at[game->basic.M] = game->basic.A;
-                        }
-                        {
-                            char *text;
-                            playdate->system->formatString(&text, "% 4d", game->basic.A);
-                            strcat(game->text, text);
-                            playdate->system->realloc(text, 0);
-                        }
-                    }
-                    strcat(game->text, "\n");
-                }
-                strcat(game->text, "\n");
-                if (game->classic) {
-                    ConsolePrintText(game->text);
-                } else {
-                    ConsolePrintText("\n");
-                }
-                GameBasicGoto(game, 120);
-            }
+// 45 F.I=71TO152;@(I)=0;N.I;@(8*X+Y+62)=4,M=A.(@(8*U+V-9)),N=M/100
+//
+static void GameBasicLine45(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        for (game->basic.I = 71; game->basic.I <= 152; game->basic.I++) {
+            GameBasicSetAt(game, game->basic.I, 0);
+        }
+        GameBasicSetAt(game, 8 * game->basic.X + game->basic.Y + 62, 4);
+        game->basic.M = abs(GameBasicGetAt(game, 8 * game->basic.U + game->basic.V - 9));
+        game->basic.N = game->basic.M / 100;
+        GameBasicTouch(game, kGameVersionStatus);
+        GameBasicGoto(game, 50);
+    }
+}
 
-        // 220 GOS.175;J=1;GOS.375;IFIG.120
-        } else if (game->basic.run.line == 220) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 175);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.J = 1;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 2) {
-                if (!game->classic) {
-                    DisplaySetMap(kDisplayMapSector);
-                }
-                if (game->basic.I != 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 225);
-                }
-            }
+// 50 I=1;IFNF.J=1TON;GOS.165;@(J+134)=300,@(J+140)=S,@(J+146)=T;N.J
+//
+static void GameBasicLine50(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.I = 1;
+        for (game->basic.J = 1; game->basic.J <= game->basic.N; game->basic.J++) {
+            GameBasicCall165(game);
+            GameBasicSetAt(game, game->basic.J + 134, 300);
+            GameBasicSetAt(game, game->basic.J + 140, game->basic.S);
+            GameBasicSetAt(game, game->basic.J + 146, game->basic.T);
+        }
+        GameBasicGoto(game, 55);
+    }
+}
 
-        // 225 M=8*U+V-9,@(M)=A.(@(M))
-        // 230 PR.;F.I=1TO8;PR.#1,I,;F.J=1TO8;M=@(8*I+J+62);IFM=0PR." .",
-        // 235 IFM=1PR." K",
-        // 240 IFM=2PR." B",
-        // 245 IFM=3PR." *",
-        // 250 IFM=4PR." E",
-        // 255 N.J;PR.;N.I;PR." ",;F.I=1TO8;PR.#2,I,;N.I;PR.;G.120
-        } else if (game->basic.run.line == 225) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.M = 8 * game->basic.U + game->basic.V - 9;
-                game->basic.at[game->basic.M] = abs(game->basic.at[game->basic.M]);
-                strcpy(game->text, "\n");
-                for (game->basic.I = 1; game->basic.I <= 8; game->basic.I++) {
-                    char *text;
-                    playdate->system->formatString(&text, "%d", game->basic.I);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                    for (game->basic.J = 1; game->basic.J <= 8; game->basic.J++) {
-                        game->basic.M = game->basic.at[8 * game->basic.I + game->basic.J + 62];
-                        if (game->basic.M == 0) {
-                            strcat(game->text, " .");
-                        } else if (game->basic.M == 1) {
-                            strcat(game->text, " K");
-                        } else if (game->basic.M == 2) {
-                            strcat(game->text, " B");
-                        } else if (game->basic.M == 3) {
-                            strcat(game->text, " *");
-                        } else if (game->basic.M == 4) {
-                            strcat(game->text, " E");
-                        }
-                    }
-                    strcat(game->text, "\n");
-                }
-                strcat(game->text, " ");
-                for (game->basic.I = 1; game->basic.I <= 8; game->basic.I++) {
-                    char *text;
-                    playdate->system->formatString(&text, "% 2d", game->basic.I);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                }
-                strcat(game->text, "\n\n");
-                if (game->classic) {
-                    ConsolePrintText(game->text);
-                } else {
-                    ConsolePrintText("\n");
-                }
-                GameBasicGoto(game, 120);
-            }
 
-        // 260 J=4;GOS.375;IFIG.120
-        } else if (game->basic.run.line == 260) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = 4;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.I != 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 265);
-                }
-            }
+// 55 GOS.175;M=M-100*N,I=2;IFM/10GOS.165
+//
+static void GameBasicLine55(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicGosub(game, 175);
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.M = game->basic.M - 100 * game->basic.N;
+        game->basic.I = 2;
+        if (game->basic.M / 10 != 0) {
+            GameBasicCall165(game);
+        }
+        GameBasicGoto(game, 60);
+    }
+}
 
-        // 265 IN." ENERGIZED. ","UNITS TO FIRE"A;IFA<1G.120
-        } else if (game->basic.run.line == 265) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText(" ENERGIZED. UNITS TO FIRE? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                ConsoleInputNumber(1, 1, game->basic.E);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.A = ConsoleGetInputedNumber();
-                if (game->basic.A < 1) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 270);
-                }
-            }
 
-        // 270 IFA>EPR.'SPOCK: "WE HAVE ONLY ',#1,E,' UNITS."';G.120
-        } else if (game->basic.run.line == 270) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.A > game->basic.E) {
-                    char *text;
-                    playdate->system->formatString(&text, "SPOCK: \"WE HAVE ONLY %d UNITS.\"\n", game->basic.E);
-                    strcpy(game->text, text);
-                    playdate->system->realloc(text, 0);
-                    ConsolePrintText(game->text);
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 275);
-                }
-            }
+// 60 M=M-M/10*10,I=3;IFMF.J=1TOM;GOS.165;N.J
+//
+static void GameBasicLine60(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.M = game->basic.M - game->basic.M / 10 * 10;
+        game->basic.I = 3;
+        for (game->basic.J = 1; game->basic.J <= game->basic.M; game->basic.J++) {
+            GameBasicCall165(game);
+        }
+        GameBasicGoto(game, 65);
+    }
+}
 
-        // 275 E=E-A;IFN<1PR."PHASER FIRED AT EMPTY SPACE.";G.65
-        } else if (game->basic.run.line == 275) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.E = game->basic.E - game->basic.A;
-                if (game->basic.N < 1) {
-                    ConsolePrintText("PHASER FIRED AT EMPTY SPACE.\n\n");
-                    GameBasicGoto(game, 65);
-                } else {
-                    GameBasicGoto(game, 280);
-                }
-            }
 
-        // 280 A=A/N;F.M=135TO140;IF@(M)=0G.290
-        // 285 GOS.295;PR.#3,S," UNITS HIT ",;GOS.305
-        // 290 N.M;G.65
-        } else if (game->basic.run.line == 280) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.A = game->basic.A / game->basic.N;
-                game->basic.M = 135;
-                GameBasicGoto(game, 285);
-            }
-        } else if (game->basic.run.line == 285) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.at[game->basic.M] == 0) {
-                    GameBasicGoto(game, 290);
-                } else {
-                    GameBasicGosub(game, 295);
-                }
-            } if (game->basic.run.sentence == 1) {
-                char *text;
-                playdate->system->formatString(&text, "%d UNITS HIT ", game->basic.S);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGosub(game, 305);
-            } if (game->basic.run.sentence == 2) {
-                GameBasicGoto(game, 290);
-            }
-        } else if (game->basic.run.line == 290) {
-            if (game->basic.run.sentence == 0) {
-                ++game->basic.M;
-                if (game->basic.M <= 140) {
-                    GameBasicGoto(game, 285);
-                } else {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 65);
-                }
+// 65 GOS.145;GOS.325;IFKG.95
+// 155 IFO=0PR.'SULU: "CAPTAIN, WE ARE DOCKED AT STARBASE."
+//
+static void GameBasicLine65(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameBasicCall145(game)) {
+            if (game->basic.O == 0) {
+                ConsolePrintText("SULU: \"CAPTAIN, WE ARE DOCKED AT STARBASE.\"\n");
             }
+            GameBasicCall160(game);
+        }
+        GameBasicGosub(game, 325);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.K != 0) {
+            GameBasicGoto(game, 95);
+        } else {
+            GameBasicGoto(game, 70);
+        }
+    }
+}
 
-        // 295 IFA>1090PR."...OVERLOADED..";J=4,@(67)=1,A=9;GOS.375
-        // 300 I=@(M+6)-X,J=@(M+12)-Y,S=A*30/(30+I*I+J*J)+1;R.
-        } else if (game->basic.run.line == 295) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.A > 1090) {
-                    ConsolePrintText("...OVERLOADED..\n");
-                    game->basic.J = 4;
-                    game->basic.at[67] = 1;
-                    game->basic.A = 9;
-                    GameBasicGosub(game, 375);
-                } else {
-                    GameBasicNext(game);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.I = game->basic.at[game->basic.M + 6] - game->basic.X;
-                game->basic.J = game->basic.at[game->basic.M + 12] - game->basic.Y;
-                game->basic.S = game->basic.A * 30 / (30 + game->basic.I * game->basic.I + game->basic.J * game->basic.J) + 1;
-                GameBasicReturn(game);
-            }
+// 70 PR.;PR."MISSION ACCOMPLISHED.";IFD<3PR."BOY, YOU BARELY MADE IT.
+//
+static void GameBasicLine70(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("\nMISSION ACCOMPLISHED.\n");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.D < 3) {
+            ConsolePrintText("BOY, YOU BARELY MADE IT.\n");
+        }
+        GameBasicGoto(game, 75);
+    }
+}
 
-        // 305 PR."KLINGON AT S-",#1,@(M+6),@(M+12),;@(M)=@(M)-S
-        } else if (game->basic.run.line == 305) {
-            if (game->basic.run.sentence == 0) {
-                char *text;
-                playdate->system->formatString(&text, "KLINGON AT S-%d%d", game->basic.at[game->basic.M + 6], game->basic.at[game->basic.M + 12]);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.at[game->basic.M] = game->basic.at[game->basic.M] - game->basic.S;
-                GameBasicGoto(game, 310);
-            }
+// 75 IFD>5PR."GOOD WORK...";IFD>9PR."FANTASTIC!";IFD>13PR."UNBELIEVABLE!
+//
+static void GameBasicLine75(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.D > 5) {
+            ConsolePrintText("GOOD WORK...\n");
+            GameBasicNext(game);
+        } else {
+            GameBasicGoto(game, 80);
+        }
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.D > 9) {
+            ConsolePrintText("FANTASTIC!\n");
+            GameBasicNext(game);
+        } else {
+            GameBasicGoto(game, 80);
+        }
+    } else if (game->basic.run.sentence ==2) {
+        if (game->basic.D > 13) {
+            ConsolePrintText("UNBELIEVABLE!\n");
+        }
+        GameBasicGoto(game, 80);
+    }
+}
 
-        // 310 IF@(M)>0PR." **DAMAGED**";R.
-        } else if (game->basic.run.line == 310) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.at[game->basic.M] > 0) {
-                    ConsolePrintText(" **DAMAGED**\n");
-                    GameBasicReturn(game);
-                } else {
-                    GameBasicGoto(game, 315);
-                }
-            }
+// 80 D=30-D,I=H*100/D*10;PR.#1,H," KLINGONS IN ",D," STARDATES. (",I,")
+//
+static void GameBasicLine80(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.D = 30 - game->basic.D;
+        GameBasicTouch(game, kGameVersionStatus);
+        game->basic.I = game->basic.H * 100 / game->basic.D * 10;
+        GameTextClear(game);
+        GameTextAppendNumber(game, game->basic.H, 0, ' ');
+        GameTextAppend(game, " KLINGONS IN ");
+        GameTextAppendNumber(game, game->basic.D, 0, ' ');
+        GameTextAppend(game, " STARDATES. (");
+        GameTextAppendNumber(game, game->basic.I, 0, ' ');
+        GameTextAppend(game, ")\n");
+        ConsolePrintText(game->text);
+        GameBasicGoto(game, 85);
+    }
+}
 
-        // 315 @(M)=0,I=8*U+V-9,J=@(I)/A.(@(I)),@(I)=@(I)-100*J,K=K-1
-        } else if (game->basic.run.line == 315) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.at[game->basic.M] = 0;
-                game->basic.I = 8 * game->basic.U + game->basic.V - 9;
-                game->basic.J = game->basic.at[game->basic.I] / abs(game->basic.at[game->basic.I]);
-                game->basic.at[game->basic.I] = game->basic.at[game->basic.I] - 100 * game->basic.J;
-                game->basic.K = game->basic.K - 1;
-                GameBasicGoto(game, 320);
-            }
+// 85 J=100*(C=0)-5*C;PR.#1,C," CASUALTIES INCURRED. (",J,")
+//
+static void GameBasicLine85(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = 100 * (game->basic.C == 0 ? 1 : 0) - 5 * game->basic.C;
+        GameTextClear(game);
+        GameTextAppendNumber(game, game->basic.C, 0, ' ');
+        GameTextAppend(game, " CASUALTIES INCURRED. (");
+        GameTextAppendNumber(game, game->basic.J, 0, ' ');
+        GameTextAppend(game, ")\n");
+        ConsolePrintText(game->text);
+        GameBasicGoto(game, 90);
+    }
+}
 
-        // 320 I=8*@(M+6)+@(M+12)+62,@(I)=0,N=N-1;PR." ***DESTROYED***";R.
-        } else if (game->basic.run.line == 320) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.I = 8 * game->basic.at[game->basic.M + 6] + game->basic.at[game->basic.M + 12] + 62;
-                game->basic.at[game->basic.I] = 0;
-                game->basic.N = game->basic.N - 1;
-                ConsolePrintText(" ***DESTROYED***\n");
-                GameBasicReturn(game);
-            }
+// 90 PR."YOUR SCORE:",I+J;G.110
+//
+static void GameBasicLine90(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppend(game, "YOUR SCORE: ");
+        GameTextAppendNumber(game, game->basic.I + game->basic.J, 0, ' ');
+        GameTextAppend(game, "\n");
+        ConsolePrintText(game->text);
+        GameBasicGoto(game, 110);
+    }
+}
 
-        // 325 IFN=0R.
-        } else if (game->basic.run.line == 325) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.N == 0) {
-                    GameBasicReturn(game);
-                } else {
-                    GameBasicGoto(game, 330);
-                }
-            }
+// 95 IFD<0PR."IT'S TOO LATE, THE FEDERATION HAS BEEN CONQUERED.";G.110
+//
+static void GameBasicLine95(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.D < 0) {
+            ConsolePrintText("IT'S TOO LATE, THE FEDERATION HAS BEEN CONQUERED.n");
+            GameBasicGoto(game, 110);
+        } else {
+            GameBasicGoto(game, 100);
+        }
+    }
+}
 
-        // 330 PR."KLINGON ATTACK";IFOPR."STARBASE PROTECTS ENTERPRISE";R.
-        } else if (game->basic.run.line == 330) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("KLINGON ATTACK\n");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.O != 0) {
-                    ConsolePrintText("STARBASE PROTECTS ENTERPRISE\n");
-                    GameBasicReturn(game);
-                } else {
-                    GameBasicGoto(game, 335);
-                }
-            }
+// 100 IFE>=0G.120
+//
+static void GameBasicLine100(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.E >= 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 105);
+        }
+    }
+}
 
-        // 335 T=0;F.M=135TO140;IF@(M)=0G.350
-        // 340 A=(@(M)+R.(@(M)))/2;GOS.295;T=T+S,I=@(M+6),J=@(M+12)
-        // 345 PR.#3,S," UNITS HIT FROM KLINGON AT S-",#1,I,J
-        } else if (game->basic.run.line == 335) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.T = 0;
-                game->basic.M = 135;
-                GameBasicGoto(game, 336);
-            }
-        } else if (game->basic.run.line == 336) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.at[game->basic.M] == 0) {
-                    GameBasicGoto(game, 350);
-                } else {
-                    game->basic.A = (game->basic.at[game->basic.M] + (rand() % game->basic.at[game->basic.M] + 1)) / 2;
-                    GameBasicGosub(game, 295);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.T = game->basic.T + game->basic.S;
-                game->basic.I = game->basic.at[game->basic.M + 6];
-                game->basic.J = game->basic.at[game->basic.M + 12];
-                char *text;
-                playdate->system->formatString(&text, "%d UNITS HIT FROM KLINGON AT S-%d%d\n", game->basic.S, game->basic.I, game->basic.J);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 350);
-            } 
-
-        // 350 N.M;E=E-T;IFE<=0PR."*** BANG ***";R.
-        } else if (game->basic.run.line == 350) {
-            if (game->basic.run.sentence == 0) {
-                ++game->basic.M;
-                if (game->basic.M <= 140) {
-                    GameBasicGoto(game, 336);
-                } else {
-                    GameBasicNext(game);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.E = game->basic.E - game->basic.T;
-                if (game->basic.E <= 0) {
-                    ConsolePrintText("*** BANG ***\n");
-                    GameBasicReturn(game);
-                } else {
-                    GameBasicGoto(game, 355);
-                }
-            }
+// 105 PR."ENTERPRISE DESTROYED";IFH-K>9PR."BUT YOU WERE A GOOD MAN
+//
+static void GameBasicLine105(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("ENTERPRISE DESTROYED\n");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.H - game->basic.K > 9) {
+            ConsolePrintText("BUT YOU WERE A GOOD MAN\n");
+        }
+        GameBasicGoto(game, 110);
+    }
+}
 
-        // 355 PR.#1,E," UNITS OF ENERGY LEFT.";IFR.(E/4)>TR.
-        } else if (game->basic.run.line == 355) {
-            if (game->basic.run.sentence == 0) {
-                char *text;
-                playdate->system->formatString(&text, "%d UNITS OF ENERGY LEFT.\n", game->basic.E);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                if ((rand() % (game->basic.E / 4) + 1) > game->basic.T) {
-                    GameBasicReturn(game);
-                } else {
-                    GameBasicGoto(game, 360);
-                }
-            }
+// 110 Y=987;PR.;IN."ANOTHERE GAME?  ","(Y OR N)"A;IFA=YG.5
+//
+static void GameBasicLine110(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("\nANOTHERE GAME? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        static const char *items[] = {
+            "NO", 
+            "YES", 
+        };
+        ConsoleOpenMenu(items, 2);
+        GameBasicNext(game);
+    } else {
+        game->basic.A = ConsoleGetSelectedMenu();
+        if (game->basic.A == 1) {
+            GameBasicGoto(game, 5);
+        } else {
+            GameBasicGoto(game, 115);
+        }
+    }
+}
 
-        // 360 IF@(70)=0@(70)=R.(T/50+1),J=7;G.375
-        } else if (game->basic.run.line == 360) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.at[70] == 0) {
-                    game->basic.at[70] = rand() % (game->basic.T / 50 + 1) + 1;
-                    game->basic.J = 7;
-                    GameBasicGoto(game, 375);
-                } else {
-                    GameBasicGoto(game, 365);
-                }
-            }
+// 115 PR."GOOD BYE.";STOP
+//
+static void GameBasicLine115(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("GOOD BYE.");
+        GameBasicNext(game);
+    } else {
+        ;
+    }
+}
 
-        // 365 J=R.(6),@(J+63)=R.(T/99+1)+@(J+63),I=R.(8)+1,C=C+I
-        } else if (game->basic.run.line == 365) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = rand() % 6 + 1;
-                game->basic.at[game->basic.J + 63] = rand() % (game->basic.T / 99 + 1) + 1 + game->basic.at[game->basic.J + 63];
-                game->basic.I = (rand() % 8 + 1) + 1;
-                game->basic.C = game->basic.C + game->basic.I;
-                GameBasicGoto(game, 370);
-            }
+// 120 S=220,G=180,L=200,P=260,R=420,W=465,T=555;IN."CAPTAIN"A
+// 125 IF(A=S)+(A=G)+(A=L)+(A=P)+(A=R)+(A=W)+(A=T)G.A
+// 130 PR."R=REPORT       S=SR. SENSOR   L=LR. SENSOR
+// 135 PR."G=GALAXY MAP   P=PHASER       T=TORPEDO
+// 140 PR."W=WARP ENGINE  **PLEASE USE ONE OF THESE COMMANDS***";G.120
+//
+static void GameBasicLine120(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("CAPTAIN? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        static const char *items[] = {
+            "REPORT", 
+            "SHORT RANGE SENSOR", 
+            "LONG RANGE SENSOR", 
+            "GALAXY MAP", 
+            "PHASER", 
+            "TORPEDO", 
+            "WARP ENGINE"
+        };
+        ConsoleOpenMenu(items, 7);
+        GameBasicNext(game);
+    } else {
+        game->basic.A = ConsoleGetSelectedMenu();
+        // 120 S=220,G=180,L=200,P=260,R=420,W=465,T=555;IN."CAPTAIN"A
+        if (game->basic.A == 0) {
+            GameBasicGoto(game, 420);
+        } else if (game->basic.A == 1) {
+            GameBasicGoto(game, 220);
+        } else if (game->basic.A == 2) {
+            GameBasicGoto(game, 200);
+        } else if (game->basic.A == 3) {
+            GameBasicGoto(game, 180);
+        } else if (game->basic.A == 4) {
+            GameBasicGoto(game, 260);
+        } else if (game->basic.A == 5) {
+            GameBasicGoto(game, 555);
+        } else if (game->basic.A == 6) {
+            GameBasicGoto(game, 465);
+        }
+    }
+}
 
-        // 370 PR.'MC COY: "SICKBAY TO BRIDGE, WE SUFFERED',#2,I,' CASUALTIES."
-        } else if (game->basic.run.line == 370) {
-            if (game->basic.run.sentence == 0) {
-                char *text;
-                playdate->system->formatString(&text, "MC COY: \"SICKBAY TO BRIDGE, WE SUFFERED %d CASUALTIES.\"\n", game->basic.I);
-                strcpy(game->text, text);
-                playdate->system->realloc(text, 0);
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 375);
-            }
+// 175 PR."ENTERPRISE IN Q-",#1,U,V," S-",X,Y;R.
+//
+static void GameBasicLine175(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppend(game, "ENTERPRISE IN Q-");
+        GameTextAppendNumber(game, game->basic.U, 0, ' ');
+        GameTextAppendNumber(game, game->basic.V, 0, ' ');
+        GameTextAppend(game, " S-");
+        GameTextAppendNumber(game, game->basic.X, 0, ' ');
+        GameTextAppendNumber(game, game->basic.Y, 0, ' ');
+        GameTextAppend(game, "\n");
+        ConsolePrintText(game->text);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        GameBasicReturn(game);
+    }
+}
 
-        // 375 I=@(J+63);IFJ=1PR."SHORT RANGE SENSOR",
-        // 380 IFJ=2PR."COMPUTER DISPLAY",
-        // 385 IFJ=3PR."LONG RANGE SENSOR",
-        // 390 IFJ=4PR."PHASER",
-        // 395 IFJ=5PR."WARP ENGINE",
-        // 400 IFJ=6PR."PHOTON TORPEDO TUBES",
-        // 405 IFJ=7PR."SHIELD",
-        // 410 IFI=0R.
-        // 415 PR." DAMAGED, ",#1,I," STARDATES ESTIMATED FOR REPAIR";R.
-        } else if (game->basic.run.line == 375) {
-            if (game->basic.run.sentence == 0) {
-                 game->basic.I = game->basic.at[game->basic.J + 63];
-                 if (game->basic.J == 1) {
-                     strcpy(game->text, "SHORT RANGE SENSOR");
-                 } else if (game->basic.J == 2) {
-                     strcpy(game->text, "COMPUTER DISPLAY");
-                 } else if (game->basic.J == 3) {
-                     strcpy(game->text, "LONG RANGE SENSOR");
-                 } else if (game->basic.J == 4) {
-                     strcpy(game->text, "PHASER");
-                 } else if (game->basic.J == 5) {
-                     strcpy(game->text, "WARP ENGINE");
-                 } else if (game->basic.J == 6) {
-                     strcpy(game->text, "PHOTON TORPEDO TUBES");
-                 } else if (game->basic.J == 7) {
-                     strcpy(game->text, "SHIELD");
-                 }
-                 if (game->basic.I == 0) {
-                    ConsolePrintText(game->text);
-                 } else {
-                    char *text;
-                    playdate->system->formatString(&text, " DAMAGED, %d STARDATES ESTIMATED FOR REPAIR\n", game->basic.I);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                    ConsolePrintText(game->text);
-                 }
-                 GameBasicReturn(game);
-            }
+// 180 GOS.175;J=2;GOS.375;IFIG.120
+//
+static void GameBasicLine180(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicGosub(game, 175);
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.J = 2;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 2) {
+        DisplaySetMap(kDisplayMapGalaxy);
+        if (game->basic.I != 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 185);
+        }
+    }
+}
 
-        // 420 PR."STATUS REPORT:";PR."STARDATE",#10,3230-D;PR."TIME LEFT",#7,D
-        // 425 PR."CONDITION     ",;IFOPR."DOCKED";G.445
-        // 430 IFNPR."RED";G.445
-        // 435 IFE<999PR."YELLOW";G.445
-        // 440 PR."GREEN
-        // 445 PR."POSITION      Q-",#1,U,V," S-",X,Y;PR."ENERGY",#12,E
-        // 450 PR."TORPEDOES",#7,F;PR."KLINGONS LEFT",#3,K;PR."STARBASES",#6,B
-        } else if (game->basic.run.line == 420) {
-            if (game->basic.run.sentence == 0) {
-                {
-                    char *text;
-                    playdate->system->formatString(&text, "STATUS REPORT:\n\nSTARDATE      %d\nTIME LEFT     %d\n", 3230 - game->basic.D, game->basic.D);
-                    strcpy(game->text, text);
-                    playdate->system->realloc(text, 0);
-                }
-                strcat(game->text, "CONDITION     ");
-                if (game->basic.O != 0) {
-                    strcat(game->text, "DOCKED\n");
-                } else if (game->basic.N != 0) {
-                    strcat(game->text, "RED\n");
-                } else if (game->basic.E < 999) {
-                    strcat(game->text, "YELLOW\n");
-                } else {
-                    strcat(game->text, "GREEN\n");
-                }
-                {
-                    char *text;
-                    playdate->system->formatString(&text, "POSITION      Q-%d%d S-%d%d\nENERGY        %d\n", game->basic.U, game->basic.V, game->basic.X, game->basic.Y, game->basic.E);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                }
-                {
-                    char *text;
-                    playdate->system->formatString(&text, "TORPEDOES     %d\nKLINGONS LEFT %d\nSTARBASES     %d\n\n", game->basic.F, game->basic.K, game->basic.B);
-                    strcat(game->text, text);
-                    playdate->system->realloc(text, 0);
-                }
-                ConsolePrintText(game->text);
-                GameBasicGoto(game, 455);
-            }
+// 185 PR." OF GALAXY MAP";F.I=0TO7;PR.;PR.#1,I+1,":",;F.J=0TO7;M=@(8*I+J)
+// 190 PR.#4,(M>0)*M,;N.J;PR.;N.I;PR."  ",;F.I=0TO7;PR."  ..",;N.I;PR.
+// 195 PR."  ",;F.I=1TO8;PR.#4,I,;N.I;PR.;PR.;G.120
+//
+static void GameBasicLine185(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText(" OF GALAXY MAP\n\n");
+        GameBasicGoto(game, 120);
+    }
+}
 
-        // 455 F.J=1TO7;IF@(J+63)GOS.375
-        // 460 N.J;G.120
-        } else if (game->basic.run.line == 455) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = 1;
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.at[game->basic.J + 63] != 0) {
-                    GameBasicGosub(game, 375);
-                } else {
-                    GameBasicNext(game);
-                }
-            } else if (game->basic.run.sentence == 2) {
-                ++game->basic.J;
-                if (game->basic.J <= 7) {
-                    GameBasicBack(game);
-                } else {
-                    GameBasicGoto(game, 120);
-                }
-            }
+// 200 GOS.175;J=3;GOS.375;IFIG.120
+//
+static void GameBasicLine200(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicGosub(game, 175);
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.J = 3;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 2) {
+        DisplaySetMap(kDisplayMapGalaxy);
+        if (game->basic.I != 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 205);
+        }
+    }
+}
 
-        // 465 J=5;GOS.375;IFI=0PR.
-        } else if (game->basic.run.line == 465) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = 5;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.I == 0) {
-                    ConsolePrintText("\n");
+// 205 PR.;F.I=U-1TOU+1;F.J=V-1TOV+1;M=8*I+J-9,A=0
+// 210 IF(I>0)*(I<9)*(J>0)*(J<9)A=A.(@(M)),@(M)=A
+// 215 PR.#4,A,;N.J;PR.;N.I;G.120
+//
+static void GameBasicLine205(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        for (game->basic.I = game->basic.U - 1; game->basic.I <= game->basic.U + 1; game->basic.I++) {
+            for (game->basic.J = game->basic.V - 1; game->basic.J <= game->basic.V + 1; game->basic.J++) {
+                game->basic.M = 8 * game->basic.I + game->basic.J - 9;
+                game->basic.A = 0;
+                if (game->basic.I > 0 && game->basic.I < 9 && game->basic.J > 0 && game->basic.J < 9) {
+                    game->basic.A = abs(GameBasicGetAt(game, game->basic.M));
+                    GameBasicSetAt(game, game->basic.M, game->basic.A);
                 }
-                GameBasicGoto(game, 470);
             }
+        }
+        ConsolePrintText("\n");
+        GameBasicGoto(game, 120);
+    }
+}
 
-        // 470 IN."SECTOR DISTANCE"W;IFW<1G.120
-        } else if (game->basic.run.line == 470) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("SECTOR DISTANCE? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                ConsoleInputNumber(1, 1, 91);
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.W = ConsoleGetInputedNumber();
-                if (game->basic.W < 0) {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 475);
-                }
-            }
+// 220 GOS.175;J=1;GOS.375;IFIG.120
+//
+static void GameBasicLine220(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicGosub(game, 175);
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.J = 1;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 2) {
+        DisplaySetMap(kDisplayMapSector);
+        if (game->basic.I != 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 225);
+        }
+    }
+}
 
-        // 475 IFI*(W>2)PR.'CHEKOV: "WE CAN TRY 2 AT MOST, SIR."';G.470
-        } else if (game->basic.run.line == 475) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.I * (game->basic.W > 2 ? 1 : 0) != 0) {
-                    ConsolePrintText("CHEKOV: \"WE CAN TRY 2 AT MOST, SIR.\"\n");
-                    GameBasicGoto(game, 470);
-                } else {
-                    GameBasicGoto(game, 480);
-                }
-            }
+// 225 M=8*U+V-9,@(M)=A.(@(M))
+// 230 PR.;F.I=1TO8;PR.#1,I,;F.J=1TO8;M=@(8*I+J+62);IFM=0PR." .",
+// 235 IFM=1PR." K",
+// 240 IFM=2PR." B",
+// 245 IFM=3PR." *",
+// 250 IFM=4PR." E",
+// 255 N.J;PR.;N.I;PR." ",;F.I=1TO8;PR.#2,I,;N.I;PR.;G.120
+//
+static void GameBasicLine225(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.M = 8 * game->basic.U + game->basic.V - 9;
+        GameBasicSetAt(game, game->basic.M, abs(GameBasicGetAt(game, game->basic.M)));
+        ConsolePrintText("\n");
+        GameBasicGoto(game, 120);
+    }
+}
 
-        // 480 IFW>91W=91;PR.'SPOCK: "ARE YOU SURE, CAPTAIN?"
-        // 485 IFE<W*W/2PR.'SCOTTY: "SIR, WE DO NOT HAVE THE ENERGY."';G.120
-        } else if (game->basic.run.line == 480) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.E < game->basic.W * game->basic.W / 2) {
-                    ConsolePrintText("SCOTTY: \"SIR, WE DO NOT HAVE THE ENERGY.\"\n\n");
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 490);
-                }
-            }
+// 260 J=4;GOS.375;IFIG.120
+//
+static void GameBasicLine260(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = 4;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.I != 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 265);
+        }
+    }
+}
 
-        // 490 GOS.615;IFR=0G.120
-        } else if (game->basic.run.line == 490) {
-            if (game->basic.run.sentence == 0) {
-                GameBasicGosub(game, 615);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.R == 0) {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 495);
-                }
-            }
+// 265 IN." ENERGIZED. ","UNITS TO FIRE"A;IFA<1G.120
+//
+static void GameBasicLine265(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText(" ENERGIZED. UNITS TO FIRE? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        ConsoleInputNumber(1, 1, game->basic.E);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 2) {
+        game->basic.A = ConsoleGetInputedNumber();
+        if (game->basic.A < 1) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 270);
+        }
+    }
+}
 
-        // 495 D=D-1,E=E-W*W/2,@(8*X+Y+62)=0
-        // 500 F.M=64TO70;@(M)=(@(M)-1)*(@(M)>0);N.M
-        } else if (game->basic.run.line == 495) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.D = game->basic.D - 1;
-                game->basic.E = game->basic.E - game->basic.W * game->basic.W / 2;
-                game->basic.at[8 * game->basic.X + game->basic.Y + 62] = 0;
-                for (game->basic.M = 64; game->basic.M <= 70; game->basic.M++) {
-                    game->basic.at[game->basic.M] = (game->basic.at[game->basic.M] - 1) * (game->basic.at[game->basic.M] > 0 ? 1 : 0);
-                }
-                GameBasicGoto(game, 505);
-            }
+// 270 IFA>EPR.'SPOCK: "WE HAVE ONLY ',#1,E,' UNITS."';G.120
+//
+static void GameBasicLine270(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.A > game->basic.E) {
+            GameTextClear(game);
+            GameTextAppend(game, "SPOCK: \"WE HAVE ONLY ");
+            GameTextAppendNumber(game, game->basic.E, 0, ' ');
+            GameTextAppend(game, " UNITS.\"\n");
+            ConsolePrintText(game->text);
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 275);
+        }
+    }
+}
 
-        // 505 P=45*X+22,G=45*Y+22,W=45*W;F.M=1TO8;W=W-R;IFW<-22G.525
-        // 510 P=P+S,G=G+T,I=P/45,J=G/45;IF(I<1)+(I>8)+(J<1)+(J>8)G.530
-        // 515 IF@(8*I+J+62)=0X=I,Y=J;N.M
-        } else if (game->basic.run.line == 505) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.P = 45 * game->basic.X + 22;
-                game->basic.G = 45 * game->basic.Y + 22;
-                game->basic.W = 45 * game->basic.W;
-                game->basic.M = 1;
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.W = game->basic.W - game->basic.R;
-                if (game->basic.W < -22) {
-                    GameBasicGoto(game, 525);
-                } else {
-                    game->basic.P = game->basic.P + game->basic.S;
-                    game->basic.G = game->basic.G + game->basic.T;
-                    game->basic.I = game->basic.P / 45;
-                    game->basic.J = game->basic.G / 45;
-                    if (game->basic.I < 1 || game->basic.I > 8 || game->basic.J < 1 || game->basic.J >8) {
-                        GameBasicGoto(game, 530);
-                    } else {
-                        if (game->basic.at[8 * game->basic.I + game->basic.J + 62] == 0) {
-                            game->basic.X = game->basic.I;
-                            game->basic.Y = game->basic.J;
-                            ++game->basic.M;
-                            if (game->basic.M <= 8) {
-                                ;
-                            } else {
-                                GameBasicGoto(game, 520);
-                            }
-                        }
-                    }
-                }
-            }
+// 275 E=E-A;IFN<1PR."PHASER FIRED AT EMPTY SPACE.";G.65
+//
+static void GameBasicLine275(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.E = game->basic.E - game->basic.A;
+        GameBasicTouch(game, kGameVersionStatus);
+        if (game->basic.N < 1) {
+            ConsolePrintText("PHASER FIRED AT EMPTY SPACE.\n\n");
+            GameBasicGoto(game, 65);
+        } else {
+            GameBasicGoto(game, 280);
+        }
+    }
+}
 
-        // 520 PR."**EMERGENCY STOP**";PR.'SPOCK: "TO ERR IS HUMAN."
-        } else if (game->basic.run.line == 520) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("**EMERGENCY STOP**\nSPOCK: \"TO ERR IS HUMAN.\"\n");
-                GameBasicGoto(game, 525);
-            }
+// 280 A=A/N;F.M=135TO140;IF@(M)=0G.290
+// 285 GOS.295;PR.#3,S," UNITS HIT ",;GOS.305
+// 290 N.M;G.65
+//
+static void GameBasicLine280(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.A = game->basic.A / game->basic.N;
+        for (int i = 0; i < kGameBasicKlingonSize; i++) {
+            game->combatPower[i] = game->basic.A;
+        }
+        GameBasicCombat(game);
+        game->basic.M = 135;
+        GameBasicGoto(game, 285);
+    }
+}
 
-        // 525 @(8*X+Y+62)=4;GOS.175;G.65
-        } else if (game->basic.run.line == 525) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.at[8 * game->basic.X + game->basic.Y + 62] = 4;
-                GameBasicGosub(game, 175);
-            } else if (game->basic.run.sentence == 1) {
-                ConsolePrintText("\n");
-                GameBasicGoto(game, 65);
-            }
+// 285 GOS.295;PR.#3,S," UNITS HIT ",;GOS.305
+//
+static void GameBasicLine285(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameBasicGetAt(game, game->basic.M) == 0) {
+            GameBasicGoto(game, 290);
+        } else {
+            GameBasicGosub(game, 295);
+        }
+    } if (game->basic.run.sentence == 1) {
+        GameTextClear(game);
+        GameTextAppendNumber(game, game->basic.S, 0, ' ');
+        GameTextAppend(game, " UNITS HIT ");
+        ConsolePrintText(game->text);
+        GameBasicGosub(game, 305);
+    } if (game->basic.run.sentence == 2) {
+        GameBasicGoto(game, 290);
+    }
+}
 
-        // 530 P=U*72+P/5+W/5*S/R-9,U=P/72,G=V*72+G/5+W/5*T/R-9,V=G/72
-        } else if (game->basic.run.line == 530) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.P = game->basic.U * 72 + game->basic.P / 5 + game->basic.W / 5 * game->basic.S / game->basic.R - 9;
-                game->basic.U = game->basic.P / 72;
-                game->basic.G = game->basic.V * 72 + game->basic.G / 5 + game->basic.W / 5 * game->basic.T / game->basic.R - 9;
-                game->basic.V = game->basic.G / 72;
-                GameBasicGoto(game, 535);
-            }
+// 290 N.M;G.65
+//
+static void GameBasicLine290(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ++game->basic.M;
+        if (game->basic.M <= 140) {
+            GameBasicGoto(game, 285);
+        } else {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 65);
+        }
+    }
+}
 
-        // 535 IFR.(9)<2PR."***SPACE STORM***";T=100;GOS.360
-         } else if (game->basic.run.line == 535) {
-            if (game->basic.run.sentence == 0) {
-                if (rand() % 9 + 1 < 2) {
-                    ConsolePrintText("***SPACE STORM***\n");
-                    GameBasicNext(game);
-                } else {
-                    GameBasicGoto(game, 540);
-                }
-            } else if (game->basic.run.sentence == 1) {
-                game->basic.T = 100;
-                GameBasicGosub(game, 360);
-            } else if (game->basic.run.sentence == 2) {
-                GameBasicGoto(game, 540);
-            }
+// 295 IFA>1090PR."...OVERLOADED..";J=4,@(67)=1,A=9;GOS.375
+// 300 I=@(M+6)-X,J=@(M+12)-Y,S=A*30/(30+I*I+J*J)+1;R.
+//
+static void GameBasicLine295(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.A > 1090) {
+            ConsolePrintText("...OVERLOADED..\n");
+            game->basic.J = 4;
+            GameBasicSetAt(game, 67, 1);
+            game->basic.A = 9;
+            for (int i = 0; i < kGameBasicKlingonSize; i++) {
+                game->combatPower[i] = game->basic.A;
+            }
+            GameBasicCombat(game);
+            GameBasicGosub(game, 375);
+        } else {
+            GameBasicNext(game);
+        }
+    } else if (game->basic.run.sentence == 1) {
+        GameBasicCall300(game);
+        GameBasicReturn(game);
+    }
+}
 
-        // 540 IF(U>0)*(U<9)*(V>0)*(V<9)X=(P+9-72*U)/9,Y=(G+9-72*V)/9;G.45
-         } else if (game->basic.run.line == 540) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.U > 0 && game->basic.U < 9 && game->basic.V > 0 && game->basic.V < 9) {
-                    game->basic.X = (game->basic.P + 9 - 72 * game->basic.U) / 9;
-                    game->basic.Y = (game->basic.G + 9 - 72 * game->basic.V) / 9;
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 45);
-                } else {
-                    GameBasicGoto(game, 545);
-                }
-            }
+// 305 PR."KLINGON AT S-",#1,@(M+6),@(M+12),;@(M)=@(M)-S
+//
+static void GameBasicLine305(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppend(game, "KLINGON AT S-");
+        GameTextAppendNumber(game, GameBasicGetAt(game, game->basic.M + 6), 0, ' ');
+        GameTextAppendNumber(game, GameBasicGetAt(game, game->basic.M + 12), 0, ' ');
+        ConsolePrintText(game->text);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        GameBasicSetAt(game, game->basic.M, GameBasicGetAt(game, game->basic.M) - game->basic.S);
+        GameBasicGoto(game, 310);
+    }
+}
 
-        // 545 PR."**YOU WANDERED OUTSIDE THE GALAXY**
-        // 550 PR."ON BOARD COMPUTER TAKES OVER, AND SAVED YOUR LIFE";G.40
-         } else if (game->basic.run.line == 545) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("**YOU WANDERED OUTSIDE THE GALAXY**\nON BOARD COMPUTER TAKES OVER, AND SAVED YOUR LIFE\n\n");
-                GameBasicGoto(game, 40);
-            }
+// 310 IF@(M)>0PR." **DAMAGED**";R.
+//
+static void GameBasicLine310(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameBasicGetAt(game, game->basic.M) > 0) {
+            ConsolePrintText(" **DAMAGED**\n");
+            GameBasicReturn(game);
+        } else {
+            GameBasicGoto(game, 315);
+        }
+    }
+}
 
-        // 555 J=6;GOS.375;IFIG.120
-         } else if (game->basic.run.line == 555) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.J = 6;
-                GameBasicGosub(game, 375);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.I != 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 560);
-                }
-            }
+// 315 @(M)=0,I=8*U+V-9,J=@(I)/A.(@(I)),@(I)=@(I)-100*J,K=K-1
+//
+static void GameBasicLine315(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicSetAt(game, game->basic.M, 0);
+        game->basic.I = 8 * game->basic.U + game->basic.V - 9;
+        game->basic.J = GameBasicGetAt(game, game->basic.I) / abs(GameBasicGetAt(game, game->basic.I));
+        GameBasicSetAt(game, game->basic.I, GameBasicGetAt(game, game->basic.I) - 100 * game->basic.J);
+        game->basic.K = game->basic.K - 1;
+        GameBasicTouch(game, kGameVersionStatus);
+        GameBasicGoto(game, 320);
+    }
+}
 
-        // 560 IFF=0PR." EMPTY";G.120
-        } else if (game->basic.run.line == 560) {
-            if (game->basic.run.sentence == 0) {
-                if (game->basic.F == 0) {
-                    ConsolePrintText(" EMPTY\n");
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 565);
-                }
-            }
+// 320 I=8*@(M+6)+@(M+12)+62,@(I)=0,N=N-1;PR." ***DESTROYED***";R.
+//
+static void GameBasicLine320(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.I = 8 * GameBasicGetAt(game, game->basic.M + 6) + GameBasicGetAt(game, game->basic.M + 12) + 62;
+        GameBasicSetAt(game, game->basic.I, 0);
+        game->basic.N = game->basic.N - 1;
+        GameBasicTouch(game, kGameVersionStatus);
+        ConsolePrintText(" ***DESTROYED***\n");
+        GameBasicReturn(game);
+    }
+}
+
+// 325 IFN=0R.
+//
+static void GameBasicLine325(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.N == 0) {
+            GameBasicReturn(game);
+        } else {
+            GameBasicGoto(game, 330);
+        }
+    }
+}
+
+// 330 PR."KLINGON ATTACK";IFOPR."STARBASE PROTECTS ENTERPRISE";R.
+//
+static void GameBasicLine330(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("KLINGON ATTACK\n");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.O != 0) {
+            ConsolePrintText("STARBASE PROTECTS ENTERPRISE\n");
+            GameBasicReturn(game);
+        } else {
+            GameBasicGoto(game, 335);
+        }
+    }
+}
+
+// 335 T=0;F.M=135TO140;IF@(M)=0G.350
+// 340 A=(@(M)+R.(@(M)))/2;GOS.295;T=T+S,I=@(M+6),J=@(M+12)
+// 345 PR.#3,S," UNITS HIT FROM KLINGON AT S-",#1,I,J
+//
+static void GameBasicLine335(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.T = 0;
+        for (int i = 0; i < kGameBasicKlingonSize; i++) {
+            int energy = game->basic.klingonEnergy[i];
+            game->combatPower[i] = energy != 0 ? (energy + GameRandom(game, energy)) / 2 : 0;
+        }
+        GameBasicCombat(game);
+        game->basic.M = 135;
+        GameBasicGoto(game, 336);
+    }
+}
+
+// 340 A=(@(M)+R.(@(M)))/2;GOS.295;T=T+S,I=@(M+6),J=@(M+12)
+// 345 PR.#3,S," UNITS HIT FROM KLINGON AT S-",#1,I,J
+//
+static void GameBasicLine336(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameBasicGetAt(game, game->basic.M) == 0) {
+            GameBasicGoto(game, 350);
+        } else {
+            game->basic.A = game->combatPower[game->basic.M - 135];
+            // A <= @(M) <= 300 なので 295 の過負荷は起こらない
+            GameBasicCall300(game);
+            game->basic.T = game->basic.T + game->basic.S;
+            game->basic.I = GameBasicGetAt(game, game->basic.M + 6);
+            game->basic.J = GameBasicGetAt(game, game->basic.M + 12);
+            GameTextClear(game);
+            GameTextAppendNumber(game, game->basic.S, 0, ' ');
+            GameTextAppend(game, " UNITS HIT FROM KLINGON AT S-");
+            GameTextAppendNumber(game, game->basic.I, 0, ' ');
+            GameTextAppendNumber(game, game->basic.J, 0, ' ');
+            GameTextAppend(game, "\n");
+            ConsolePrintText(game->text);
+            GameBasicGoto(game, 350);
+        }
+    }
+}
+
+// 350 N.M;E=E-T;IFE<=0PR."*** BANG ***";R.
+//
+static void GameBasicLine350(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ++game->basic.M;
+        if (game->basic.M <= 140) {
+            GameBasicGoto(game, 336);
+        } else {
+            GameBasicNext(game);
+        }
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.E = game->basic.E - game->basic.T;
+        GameBasicTouch(game, kGameVersionStatus);
+        if (game->basic.E <= 0) {
+            ConsolePrintText("*** BANG ***\n");
+            GameBasicReturn(game);
+        } else {
+            GameBasicGoto(game, 355);
+        }
+    }
+}
+
+// 355 PR.#1,E," UNITS OF ENERGY LEFT.";IFR.(E/4)>TR.
+//
+static void GameBasicLine355(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppendNumber(game, game->basic.E, 0, ' ');
+        GameTextAppend(game, " UNITS OF ENERGY LEFT.\n");
+        ConsolePrintText(game->text);
+        if (GameRandom(game, game->basic.E / 4) > game->basic.T) {
+            GameBasicReturn(game);
+        } else {
+            GameBasicGoto(game, 360);
+        }
+    }
+}
+
+// 360 IF@(70)=0@(70)=R.(T/50+1),J=7;G.375
+//
+static void GameBasicLine360(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameBasicGetAt(game, 70) == 0) {
+            GameBasicSetAt(game, 70, GameRandom(game, game->basic.T / 50 + 1));
+            game->basic.J = 7;
+            GameBasicGoto(game, 375);
+        } else {
+            GameBasicGoto(game, 365);
+        }
+    }
+}
+
+// 365 J=R.(6),@(J+63)=R.(T/99+1)+@(J+63),I=R.(8)+1,C=C+I
+//
+static void GameBasicLine365(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = GameRandom(game, 6);
+        GameBasicSetAt(game, game->basic.J + 63, GameRandom(game, game->basic.T / 99 + 1) + GameBasicGetAt(game, game->basic.J + 63));
+        game->basic.I = GameRandom(game, 8) + 1;
+        game->basic.C = game->basic.C + game->basic.I;
+        GameBasicGoto(game, 370);
+    }
+}
+
+// 370 PR.'MC COY: "SICKBAY TO BRIDGE, WE SUFFERED',#2,I,' CASUALTIES."
+//
+static void GameBasicLine370(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppend(game, "MC COY: \"SICKBAY TO BRIDGE, WE SUFFERED ");
+        GameTextAppendNumber(game, game->basic.I, 0, ' ');
+        GameTextAppend(game, " CASUALTIES.\"\n");
+        ConsolePrintText(game->text);
+        GameBasicGoto(game, 375);
+    }
+}
+
+// 375 I=@(J+63);IFJ=1PR."SHORT RANGE SENSOR",
+// 380 IFJ=2PR."COMPUTER DISPLAY",
+// 385 IFJ=3PR."LONG RANGE SENSOR",
+// 390 IFJ=4PR."PHASER",
+// 395 IFJ=5PR."WARP ENGINE",
+// 400 IFJ=6PR."PHOTON TORPEDO TUBES",
+// 405 IFJ=7PR."SHIELD",
+// 410 IFI=0R.
+// 415 PR." DAMAGED, ",#1,I," STARDATES ESTIMATED FOR REPAIR";R.
+//
+static void GameBasicLine375(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+         game->basic.I = GameBasicGetAt(game, game->basic.J + 63);
+         if (game->basic.J == 1) {
+             GameTextClear(game);
+             GameTextAppend(game, "SHORT RANGE SENSOR");
+         } else if (game->basic.J == 2) {
+             GameTextClear(game);
+             GameTextAppend(game, "COMPUTER DISPLAY");
+         } else if (game->basic.J == 3) {
+             GameTextClear(game);
+             GameTextAppend(game, "LONG RANGE SENSOR");
+         } else if (game->basic.J == 4) {
+             GameTextClear(game);
+             GameTextAppend(game, "PHASER");
+         } else if (game->basic.J == 5) {
+             GameTextClear(game);
+             GameTextAppend(game, "WARP ENGINE");
+         } else if (game->basic.J == 6) {
+             GameTextClear(game);
+             GameTextAppend(game, "PHOTON TORPEDO TUBES");
+         } else if (game->basic.J == 7) {
+             GameTextClear(game);
+             GameTextAppend(game, "SHIELD");
+         }
+         if (game->basic.I == 0) {
+            ConsolePrintText(game->text);
+         } else {
+            GameTextAppend(game, " DAMAGED, ");
+            GameTextAppendNumber(game, game->basic.I, 0, ' ');
+            GameTextAppend(game, " STARDATES ESTIMATED FOR REPAIR\n");
+            ConsolePrintText(game->text);
+         }
+         GameBasicReturn(game);
+    }
+}
+
+// 420 PR."STATUS REPORT:";PR."STARDATE",#10,3230-D;PR."TIME LEFT",#7,D
+// 425 PR."CONDITION     ",;IFOPR."DOCKED";G.445
+// 430 IFNPR."RED";G.445
+// 435 IFE<999PR."YELLOW";G.445
+// 440 PR."GREEN
+// 445 PR."POSITION      Q-",#1,U,V," S-",X,Y;PR."ENERGY",#12,E
+// 450 PR."TORPEDOES",#7,F;PR."KLINGONS LEFT",#3,K;PR."STARBASES",#6,B
+//
+static void GameBasicLine420(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameTextClear(game);
+        GameTextAppend(game, "STATUS REPORT:\n\nSTARDATE      ");
+        GameTextAppendNumber(game, 3230 - game->basic.D, 0, ' ');
+        GameTextAppend(game, "\nTIME LEFT     ");
+        GameTextAppendNumber(game, game->basic.D, 0, ' ');
+        GameTextAppend(game, "\n");
+        GameTextAppend(game, "CONDITION     ");
+        if (game->basic.O != 0) {
+            GameTextAppend(game, "DOCKED\n");
+        } else if (game->basic.N != 0) {
+            GameTextAppend(game, "RED\n");
+        } else if (game->basic.E < 999) {
+            GameTextAppend(game, "YELLOW\n");
+        } else {
+            GameTextAppend(game, "GREEN\n");
+        }
+        GameTextAppend(game, "POSITION      Q-");
+        GameTextAppendNumber(game, game->basic.U, 0, ' ');
+        GameTextAppendNumber(game, game->basic.V, 0, ' ');
+        GameTextAppend(game, " S-");
+        GameTextAppendNumber(game, game->basic.X, 0, ' ');
+        GameTextAppendNumber(game, game->basic.Y, 0, ' ');
+        GameTextAppend(game, "\nENERGY        ");
+        GameTextAppendNumber(game, game->basic.E, 0, ' ');
+        GameTextAppend(game, "\n");
+        GameTextAppend(game, "TORPEDOES     ");
+        GameTextAppendNumber(game, game->basic.F, 0, ' ');
+        GameTextAppend(game, "\nKLINGONS LEFT ");
+        GameTextAppendNumber(game, game->basic.K, 0, ' ');
+        GameTextAppend(game, "\nSTARBASES     ");
+        GameTextAppendNumber(game, game->basic.B, 0, ' ');
+        GameTextAppend(game, "\n\n");
+        ConsolePrintText(game->text);
+        GameBasicGoto(game, 455);
+    }
+}
+
+// 455 F.J=1TO7;IF@(J+63)GOS.375
+// 460 N.J;G.120
+//
+static void GameBasicLine455(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = 1;
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (GameBasicGetAt(game, game->basic.J + 63) != 0) {
+            GameBasicGosub(game, 375);
+        } else {
+            GameBasicNext(game);
+        }
+    } else if (game->basic.run.sentence == 2) {
+        ++game->basic.J;
+        if (game->basic.J <= 7) {
+            GameBasicBack(game);
+        } else {
+            GameBasicGoto(game, 120);
+        }
+    }
+}
+
+// 465 J=5;GOS.375;IFI=0PR.
+//
+static void GameBasicLine465(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = 5;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.I == 0) {
+            ConsolePrintText("\n");
+        }
+        GameBasicGoto(game, 470);
+    }
+}
+
+// 470 IN."SECTOR DISTANCE"W;IFW<1G.120
+//
+static void GameBasicLine470(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("SECTOR DISTANCE? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        ConsoleInputNumber(1, 1, 91);
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 2) {
+        game->basic.W = ConsoleGetInputedNumber();
+        if (game->basic.W < 0) {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 475);
+        }
+    }
+}
+
+// 475 IFI*(W>2)PR.'CHEKOV: "WE CAN TRY 2 AT MOST, SIR."';G.470
+//
+static void GameBasicLine475(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.I * (game->basic.W > 2 ? 1 : 0) != 0) {
+            ConsolePrintText("CHEKOV: \"WE CAN TRY 2 AT MOST, SIR.\"\n");
+            GameBasicGoto(game, 470);
+        } else {
+            GameBasicGoto(game, 480);
+        }
+    }
+}
+
+// 480 IFW>91W=91;PR.'SPOCK: "ARE YOU SURE, CAPTAIN?"
+// 485 IFE<W*W/2PR.'SCOTTY: "SIR, WE DO NOT HAVE THE ENERGY."';G.120
+//
+static void GameBasicLine480(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.E < game->basic.W * game->basic.W / 2) {
+            ConsolePrintText("SCOTTY: \"SIR, WE DO NOT HAVE THE ENERGY.\"\n\n");
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 490);
+        }
+    }
+}
+
+// 490 GOS.615;IFR=0G.120
+//
+static void GameBasicLine490(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicGosub(game, 615);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.R == 0) {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 495);
+        }
+    }
+}
+
+// 495 D=D-1,E=E-W*W/2,@(8*X+Y+62)=0
+// 500 F.M=64TO70;@(M)=(@(M)-1)*(@(M)>0);N.M
+//
+static void GameBasicLine495(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.D = game->basic.D - 1;
+        game->basic.E = game->basic.E - game->basic.W * game->basic.W / 2;
+        GameBasicTouch(game, kGameVersionStatus);
+        GameBasicSetAt(game, 8 * game->basic.X + game->basic.Y + 62, 0);
+        for (game->basic.M = 64; game->basic.M <= 70; game->basic.M++) {
+            GameBasicSetAt(game, game->basic.M, (GameBasicGetAt(game, game->basic.M) - 1) * (GameBasicGetAt(game, game->basic.M) > 0 ? 1 : 0));
+        }
+        GameBasicGoto(game, 505);
+    }
+}
 
-        // 565 PR." LOADED";GOS.615;IFR=0G.120
-        } else if (game->basic.run.line == 565) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText(" LOADED\n");
-                GameBasicGosub(game, 615);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.R == 0) {
-                    GameBasicGoto(game, 120);
-                } else {
-                    GameBasicGoto(game, 570);
+// 505 P=45*X+22,G=45*Y+22,W=45*W;F.M=1TO8;W=W-R;IFW<-22G.525
+// 510 P=P+S,G=G+T,I=P/45,J=G/45;IF(I<1)+(I>8)+(J<1)+(J>8)G.530
+// 515 IF@(8*I+J+62)=0X=I,Y=J;N.M
+//
+static void GameBasicLine505(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.P = 45 * game->basic.X + 22;
+        game->basic.G = 45 * game->basic.Y + 22;
+        game->basic.W = 45 * game->basic.W;
+        game->basic.M = 1;
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        const struct GameBasicCourse *course = GameBasicGetCourse(game->course);
+        uint64_t bits = 
+            game->basic.sectorBits[kGameBasicSectorKlingon] | 
+            game->basic.sectorBits[kGameBasicSectorBase] | 
+            game->basic.sectorBits[kGameBasicSectorStar] | 
+            game->basic.sectorBits[kGameBasicSectorEnterprise];
+        int x = game->basic.X;
+        int y = game->basic.Y;
+        int line = 530;
+        for (int m = 0; m < kGameBasicCourseStep; m++) {
+            game->basic.W = game->basic.W - game->basic.R;
+            if (game->basic.W < -22) {
+                line = 525;
+                break;
+            }
+            game->basic.P = game->basic.P + game->basic.S;
+            game->basic.G = game->basic.G + game->basic.T;
+            game->basic.I = x + course->steps[m][0];
+            game->basic.J = y + course->steps[m][1];
+            if (game->basic.I < 1 || game->basic.I > 8 || game->basic.J < 1 || game->basic.J > 8) {
+                break;
+            }
+            if ((bits & ((uint64_t)1 << (8 * (game->basic.I - 1) + (game->basic.J - 1)))) == 0) {
+                game->basic.X = game->basic.I;
+                game->basic.Y = game->basic.J;
+                ++game->basic.M;
+                if (game->basic.M > 8) {
+                    line = 520;
+                    break;
                 }
             }
+        }
+        GameBasicGoto(game, line);
+    }
+}
+
+// 520 PR."**EMERGENCY STOP**";PR.'SPOCK: "TO ERR IS HUMAN."
+//
+static void GameBasicLine520(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("**EMERGENCY STOP**\nSPOCK: \"TO ERR IS HUMAN.\"\n");
+        GameBasicGoto(game, 525);
+    }
+}
+
+// 525 @(8*X+Y+62)=4;GOS.175;G.65
+//
+static void GameBasicLine525(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicSetAt(game, 8 * game->basic.X + game->basic.Y + 62, 4);
+        GameBasicGosub(game, 175);
+    } else if (game->basic.run.sentence == 1) {
+        ConsolePrintText("\n");
+        GameBasicGoto(game, 65);
+    }
+}
+
+// 530 P=U*72+P/5+W/5*S/R-9,U=P/72,G=V*72+G/5+W/5*T/R-9,V=G/72
+//
+static void GameBasicLine530(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.P = game->basic.U * 72 + game->basic.P / 5 + game->basic.W / 5 * game->basic.S / game->basic.R - 9;
+        game->basic.U = game->basic.P / 72;
+        game->basic.G = game->basic.V * 72 + game->basic.G / 5 + game->basic.W / 5 * game->basic.T / game->basic.R - 9;
+        game->basic.V = game->basic.G / 72;
+        GameBasicTouch(game, kGameVersionGalaxy);
+        GameBasicGoto(game, 535);
+    }
+}
+
+// 535 IFR.(9)<2PR."***SPACE STORM***";T=100;GOS.360
+//
+static void GameBasicLine535(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (GameRandom(game, 9) < 2) {
+            ConsolePrintText("***SPACE STORM***\n");
+            GameBasicNext(game);
+        } else {
+            GameBasicGoto(game, 540);
+        }
+    } else if (game->basic.run.sentence == 1) {
+        game->basic.T = 100;
+        GameBasicGosub(game, 360);
+    } else if (game->basic.run.sentence == 2) {
+        GameBasicGoto(game, 540);
+    }
+}
+
+// 540 IF(U>0)*(U<9)*(V>0)*(V<9)X=(P+9-72*U)/9,Y=(G+9-72*V)/9;G.45
+//
+static void GameBasicLine540(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.U > 0 && game->basic.U < 9 && game->basic.V > 0 && game->basic.V < 9) {
+            game->basic.X = (game->basic.P + 9 - 72 * game->basic.U) / 9;
+            game->basic.Y = (game->basic.G + 9 - 72 * game->basic.V) / 9;
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 45);
+        } else {
+            GameBasicGoto(game, 545);
+        }
+    }
+}
+
+// 545 PR."**YOU WANDERED OUTSIDE THE GALAXY**
+// 550 PR."ON BOARD COMPUTER TAKES OVER, AND SAVED YOUR LIFE";G.40
+//
+static void GameBasicLine545(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("**YOU WANDERED OUTSIDE THE GALAXY**\nON BOARD COMPUTER TAKES OVER, AND SAVED YOUR LIFE\n\n");
+        GameBasicGoto(game, 40);
+    }
+}
+
+// 555 J=6;GOS.375;IFIG.120
+//
+static void GameBasicLine555(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.J = 6;
+        GameBasicGosub(game, 375);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.I != 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 560);
+        }
+    }
+}
+
+// 560 IFF=0PR." EMPTY";G.120
+//
+static void GameBasicLine560(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        if (game->basic.F == 0) {
+            ConsolePrintText(" EMPTY\n");
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 565);
+        }
+    }
+}
+
+// 565 PR." LOADED";GOS.615;IFR=0G.120
+//
+static void GameBasicLine565(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText(" LOADED\n");
+        GameBasicGosub(game, 615);
+    } else if (game->basic.run.sentence == 1) {
+        if (game->basic.R == 0) {
+            GameBasicGoto(game, 120);
+        } else {
+            GameBasicGoto(game, 570);
+        }
+    }
+}
 
-        // 570 PR."TORPEDO TRACK ",;F=F-1,P=45*X+22,G=45*Y+22;F.M=1TO8
-        } else if (game->basic.run.line == 570) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("TORPEDO TRACK ");
-                game->basic.F = game->basic.F - 1;
-                game->basic.P = 45 * game->basic.X + 22;
-                game->basic.G = 45 * game->basic.Y + 22;
-                game->basic.M = 1;
-                GameBasicGoto(game, 575);
+// 570 PR."TORPEDO TRACK ",;F=F-1,P=45*X+22,G=45*Y+22;F.M=1TO8
+//
+static void GameBasicLine570(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("TORPEDO TRACK ");
+        game->basic.F = game->basic.F - 1;
+        GameBasicTouch(game, kGameVersionStatus);
+        game->basic.P = 45 * game->basic.X + 22;
+        game->basic.G = 45 * game->basic.Y + 22;
+        game->basic.M = 1;
+        GameBasicGoto(game, 575);
+    }
+}
+
+// 575 P=P+S,G=G+T,I=P/45,J=G/45;IF(I<1)+(I>8)+(J<1)+(J>8)G.585
+// 580 L=8*I+J+62,W=8*U+V-9,R=@(W)/A.(@(W));PR.#1,I,J," ",;G.585+5*@(L)
+//
+static void GameBasicLine575(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        const struct GameBasicCourse *course = GameBasicGetCourse(game->course);
+        uint64_t bits = 
+            game->basic.sectorBits[kGameBasicSectorKlingon] | 
+            game->basic.sectorBits[kGameBasicSectorBase] | 
+            game->basic.sectorBits[kGameBasicSectorStar] | 
+            game->basic.sectorBits[kGameBasicSectorEnterprise];
+        int line = 585;
+        GameTextClear(game);
+        for (; game->basic.M <= kGameBasicCourseStep; game->basic.M++) {
+            game->basic.P = game->basic.P + game->basic.S;
+            game->basic.G = game->basic.G + game->basic.T;
+            game->basic.I = game->basic.X + course->steps[game->basic.M - 1][0];
+            game->basic.J = game->basic.Y + course->steps[game->basic.M - 1][1];
+            if (game->basic.I < 1 || game->basic.I > 8 || game->basic.J < 1 || game->basic.J > 8) {
+                continue;
+            }
+            game->basic.L = 8 * game->basic.I + game->basic.J + 62;
+            game->basic.W = 8 * game->basic.U + game->basic.V - 9;
+            game->basic.R = GameBasicGetAt(game, game->basic.W) / abs(GameBasicGetAt(game, game->basic.W));
+            GameTextAppendNumber(game, game->basic.I, 0, ' ');
+            GameTextAppendNumber(game, game->basic.J, 0, ' ');
+            GameTextAppend(game, " ");
+            if ((bits & ((uint64_t)1 << (8 * (game->basic.I - 1) + (game->basic.J - 1)))) != 0) {
+                line = 585 + 5 * GameBasicGetAt(game, game->basic.L);
+                break;
             }
+        }
+        ConsolePrintText(game->text);
+        if (line == 585) {
+            game->basic.M = kGameBasicCourseStep;
+        }
+        GameBasicGoto(game, line);
+    }
+}
+
+// 585 N.M;PR.;G.65
+//
+static void GameBasicLine585(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ++game->basic.M;
+        if (game->basic.M <= 8) {
+            GameBasicGoto(game, 575);
+        } else {
+            ConsolePrintText("...MISSED\n\n");
+            GameBasicGoto(game, 65);
+        }
+    }
+}
+
+// 590 S=R.(99)+280;F.M=135TO140;IF(@(M+6)=I)*(@(M+12)=J)GOS.305
+// 592 N.M;G.65
+//
+static void GameBasicLine590(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = GameRandom(game, 99) + 280;
+        game->basic.M = 135;
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (GameBasicGetAt(game, game->basic.M + 6) == game->basic.I && GameBasicGetAt(game, game->basic.M + 12) == game->basic.J) {
+            GameBasicGosub(game, 305);
+        } else {
+            GameBasicNext(game);
+        }
+    } else if (game->basic.run.sentence == 2) {
+        ++game->basic.M;
+        if (game->basic.M <= 140) {
+            GameBasicBack(game);
+        } else {
+            ConsolePrintText("\n");
+            GameBasicGoto(game, 65);
+        }
+    }
+}
+
+// 595 B=B-1,@(L)=0,@(W)=@(W)-10*R;PR."STARBASE DESTROYED
+// 597 PR.'SPOCK: "I OFTEN FIND HUMAN BEHAVIOUR FASCINATING."';G.65
+//
+static void GameBasicLine595(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.B = game->basic.B - 1;
+        GameBasicTouch(game, kGameVersionStatus);
+        GameBasicSetAt(game, game->basic.L, 0);
+        GameBasicSetAt(game, game->basic.W, GameBasicGetAt(game, game->basic.W) - 10 * game->basic.R);
+        ConsolePrintText("STARBASE DESTROYED\n");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        ConsolePrintText("SPOCK: \"I OFTEN FIND HUMAN BEHAVIOUR FASCINATING.\"\n\n");
+        GameBasicGoto(game, 65);
+    }
+}
+
+// 600 PR."HIT A STAR";IFR.(9)<3PR."TORPEDO ABSORBED";G.65
+//
+static void GameBasicLine600(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("HIT A STAR\n");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        if (GameRandom(game, 9) < 3) {
+            ConsolePrintText("TORPEDO ABSORBED\n\n");
+            GameBasicGoto(game, 65);
+        } else {
+            GameBasicGoto(game, 605);
+        }
+    }
+}
+
+// 605 @(L)=0,@(W)=@(W)-R;IFR.(9)<6PR."STAR DESTROYED";G.65
+//
+static void GameBasicLine605(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        GameBasicSetAt(game, game->basic.L, 0);
+        GameBasicSetAt(game, game->basic.W, GameBasicGetAt(game, game->basic.W) - game->basic.R);
+        if (GameRandom(game, 9) < 6) {
+            ConsolePrintText("STAR DESTROYED\n\n");
+            GameBasicGoto(game, 65);
+        } else {
+            GameBasicGoto(game, 610);
+        }
+    }
+}
+
+// 610 T=300;PR."IT NOVAS    ***RADIATION ALARM***";GOS.360;G.65
+//
+static void GameBasicLine610(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.T = 300;
+        ConsolePrintText("IT NOVAS    ***RADIATION ALARM***\n");
+        GameBasicGosub(game, 360);
+    } else if (game->basic.run.sentence == 1) {
+        ConsolePrintText("\n");
+        GameBasicGoto(game, 65);
+    }
+}
+
+// 615 IN."COURSE (0-360)"I;IF(I>360)+(I<0)R=0;R.
+//
+static void GameBasicLine615(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        ConsolePrintText("COURSE (0-360)? ");
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 1) {
+        ConsoleInputAngle();
+        GameBasicNext(game);
+    } else if (game->basic.run.sentence == 2) {
+        game->basic.I = ConsoleGetInputedAngle();
+        game->course = game->basic.I;
+        GameBasicGoto(game, 620);
+    }
+}
+
+// 620 S=(I+45)/90,I=I-S*90,R=(45+I*I)/110+45;G.625+5*(S<4)*S
+//
+static void GameBasicLine620(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = (game->basic.I + 45) / 90;
+        game->basic.I = game->basic.I - game->basic.S * 90;
+        game->basic.R = (45 + game->basic.I * game->basic.I) / 110 + 45;
+        GameBasicGoto(game, 625 + 5 * (game->basic.S < 4 ? 1 : 0) * game->basic.S);
+    }
+}
+
+// 625 S=-45,T=I;R.
+//
+static void GameBasicLine625(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = -45;
+        game->basic.T = game->basic.I;
+        GameBasicReturn(game);
+    }
+}
+
+// 630 S=I,T=45;R.
+//
+static void GameBasicLine630(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = game->basic.I;
+        game->basic.T = 45;
+        GameBasicReturn(game);
+    }
+}
 
-        // 575 P=P+S,G=G+T,I=P/45,J=G/45;IF(I<1)+(I>8)+(J<1)+(J>8)G.585
-        } else if (game->basic.run.line == 575) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.P = game->basic.P + game->basic.S;
-                game->basic.G = game->basic.G + game->basic.T;
-                game->basic.I = game->basic.P / 45;
-                game->basic.J = game->basic.G / 45;
-                if (game->basic.I < 1 || game->basic.I > 8 || game->basic.J < 1 || game->basic.J > 8) {
-                    GameBasicGoto(game, 585);
-                } else {
-                    GameBasicGoto(game, 580);
-                }
-            }
+// 635 S=45,T=-I;R.
+//
+static void GameBasicLine635(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = 45;
+        game->basic.T = -game->basic.I;
+        GameBasicReturn(game);
+    }
+}
 
-        // 580 L=8*I+J+62,W=8*U+V-9,R=@(W)/A.(@(W));PR.#1,I,J," ",;G.585+5*@(L)
-        } else if (game->basic.run.line == 580) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.L = 8 * game->basic.I + game->basic.J + 62;
-                game->basic.W = 8 * game->basic.U + game->basic.V - 9;
-                game->basic.R = game->basic.at[game->basic.W] / abs(game->basic.at[game->basic.W]);
-                {
-                    char *text;
-                    playdate->system->formatString(&text, "%d%d ", game->basic.I, game->basic.J);
-                    strcpy(game->text, text);
-                    playdate->system->realloc(text, 0);
-                    ConsolePrintText(game->text);
-                }
-                GameBasicGoto(game, 585 + 5 * game->basic.at[game->basic.L]);
-            }
+// 640 S=-I,T=-45;R.
+//
+static void GameBasicLine640(struct Game *game)
+{
+    if (game->basic.run.sentence == 0) {
+        game->basic.S = -game->basic.I;
+        game->basic.T = -45;
+        GameBasicReturn(game);
+    }
+}
 
-        // 585 N.M;PR.;G.65
-        } else if (game->basic.run.line == 585) {
-            if (game->basic.run.sentence == 0) {
-                ++game->basic.M;
-                if (game->basic.M <= 8) {
-                    GameBasicGoto(game, 575);
-                } else {
-                    ConsolePrintText("...MISSED\n\n");
-                    GameBasicGoto(game, 65);
-                }
-            }
+// 乱数を初期化する
+//
+static void GameSeedRandom(struct Game *game, uint32_t seed)
+{
+    // splitmix32 で xoshiro128** の状態を作る
+    for (int i = 0; i < 4; i++) {
+        uint32_t z = (seed += 0x9e3779b9);
+        z = (z ^ (z >> 16)) * 0x85ebca6b;
+        z = (z ^ (z >> 13)) * 0xc2b2ae35;
+        game->random[i] = z ^ (z >> 16);
+    }
+}
 
-        // 590 S=R.(99)+280;F.M=135TO140;IF(@(M+6)=I)*(@(M+12)=J)GOS.305
-        // 592 N.M;G.65
-        } else if (game->basic.run.line == 590) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.S = (rand() % 99 + 1) + 280;
-                game->basic.M = 135;
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if (game->basic.at[game->basic.M + 6] == game->basic.I && game->basic.at[game->basic.M + 12] == game->basic.J) {
-                    GameBasicGosub(game, 305);
-                } else {
-                    GameBasicNext(game);
-                }
-            } else if (game->basic.run.sentence == 2) {
-                ++game->basic.M;
-                if (game->basic.M <= 140) {
-                    GameBasicBack(game);
-                } else {
-                    ConsolePrintText("\n");
-                    GameBasicGoto(game, 65);
-                }
-            }
+// 乱数を取得する
+//
+static uint32_t GameNextRandom(struct Game *game)
+{
+    uint32_t *s = game->random;
+    uint32_t x = s[1] * 5;
+    uint32_t result = ((x << 7) | (x >> 25)) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+    return result;
+}
 
-        // 595 B=B-1,@(L)=0,@(W)=@(W)-10*R;PR."STARBASE DESTROYED
-        // 597 PR.'SPOCK: "I OFTEN FIND HUMAN BEHAVIOUR FASCINATING."';G.65
-        } else if (game->basic.run.line == 595) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.B = game->basic.B - 1;
-                game->basic.at[game->basic.L] = 0;
-                game->basic.at[game->basic.W] = game->basic.at[game->basic.W] - 10 * game->basic.R;
-                ConsolePrintText("STARBASE DESTROYED\n");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                ConsolePrintText("SPOCK: \"I OFTEN FIND HUMAN BEHAVIOUR FASCINATING.\"\n\n");
-                GameBasicGoto(game, 65);
-            }
+// R.(n) の 1..n の乱数を取得する
+//
+static int GameRandom(struct Game *game, int n)
+{
+    // R.(0) は 0 を返す
+    if (n < 1) {
+        return 0;
+    }
 
-        // 600 PR."HIT A STAR";IFR.(9)<3PR."TORPEDO ABSORBED";G.65
-        } else if (game->basic.run.line == 600) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("HIT A STAR\n");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                if ((rand() % 9 + 1) < 3) {
-                    ConsolePrintText("TORPEDO ABSORBED\n\n");
-                    GameBasicGoto(game, 65);
-                } else {
-                    GameBasicGoto(game, 605);
-                }
-            }
+    // 乗算とシフトで偏りなく範囲に収める
+    uint64_t m = (uint64_t)GameNextRandom(game) * (uint32_t)n;
+    if ((uint32_t)m < (uint32_t)n) {
+        uint32_t threshold = (uint32_t)-n % (uint32_t)n;
+        while ((uint32_t)m < threshold) {
+            m = (uint64_t)GameNextRandom(game) * (uint32_t)n;
+        }
+    }
+    return (int)(m >> 32) + 1;
+}
 
-        // 605 @(L)=0,@(W)=@(W)-R;IFR.(9)<6PR."STAR DESTROYED";G.65
-        } else if (game->basic.run.line == 605) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.at[game->basic.L] = 0;
-                game->basic.at[game->basic.W] = game->basic.at[game->basic.W] - game->basic.R;
-                if (rand() % 9 + 1 < 6) {
-                    ConsolePrintText("STAR DESTROYED\n\n");
-                    GameBasicGoto(game, 65);
-                } else {
-                    GameBasicGoto(game, 610);
-                }
-            }
+// 145 F.I=X-(X>1)TOX+(X<8);F.J=Y-(Y>1)TOY+(Y<8)
+// 150 IF@(8*I+J+62)#2N.J;N.I;O=0;R.
+//
+static bool GameBasicCall145(struct Game *game)
+{
+    int cell = 8 * (game->basic.X - 1) + (game->basic.Y - 1);
+    uint64_t bits = 0;
+    if (cell >= 0 && cell < kGameBasicSectorSize) {
+        bits = game->basic.sectorBits[kGameBasicSectorBase] & gameBasicSectorNeighbours[cell];
+    }
+    if (bits != 0) {
+        int found = __builtin_ctzll(bits);
+        game->basic.I = found / 8 + 1;
+        game->basic.J = found % 8 + 1;
+        return true;
+    }
+    game->basic.I = game->basic.X + (game->basic.X < 8 ? 1 : 0) + 1;
+    game->basic.J = game->basic.Y + (game->basic.Y < 8 ? 1 : 0) + 1;
+    game->basic.O = 0;
+    GameBasicTouch(game, kGameVersionStatus);
+    return false;
+}
 
-        // 610 T=300;PR."IT NOVAS    ***RADIATION ALARM***";GOS.360;G.65
-        } else if (game->basic.run.line == 610) {
-            if (game->basic.run.sentence == 0) {
-                game->basic.T = 300;
-                ConsolePrintText("IT NOVAS    ***RADIATION ALARM***\n");
-                GameBasicGosub(game, 360);
-            } else if (game->basic.run.sentence == 1) {
-                ConsolePrintText("\n");
-                GameBasicGoto(game, 65);
-            }
+// 160 E=4000,F=10,O=1;F.I=64TO70;@(I)=0;N.I;R.
+//
+static void GameBasicCall160(struct Game *game)
+{
+    game->basic.E = 4000;
+    game->basic.F = 10;
+    game->basic.O = 1;
+    GameBasicTouch(game, kGameVersionStatus);
+    for (game->basic.I = 64; game->basic.I <= 70; game->basic.I++) {
+        GameBasicSetAt(game, game->basic.I, 0);
+    }
+}
 
-        // 615 IN."COURSE (0-360)"I;IF(I>360)+(I<0)R=0;R.
-        // 620 S=(I+45)/90,I=I-S*90,R=(45+I*I)/110+45;G.625+5*(S<4)*S
-        // 625 S=-45,T=I;R.
-        // 630 S=I,T=45;R.
-        // 635 S=45,T=-I;R.
-        // 640 S=-I,T=-45;R.
-        } else if (game->basic.run.line == 615) {
-            if (game->basic.run.sentence == 0) {
-                ConsolePrintText("COURSE (0-360)? ");
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 1) {
-                ConsoleInputAngle();
-                GameBasicNext(game);
-            } else if (game->basic.run.sentence == 2) {
-                game->basic.I = ConsoleGetInputedAngle();
-                game->basic.S = (game->basic.I + 45) / 90;
-                game->basic.I = game->basic.I - game->basic.S * 90;
-                game->basic.R = (45 + game->basic.I * game->basic.I) / 110 + 45;
-                int i = 625 + 5 * (game->basic.S < 4 ? 1 : 0) * game->basic.S;
-                if (i == 625) {
-                    game->basic.S = -45;
-                    game->basic.T = game->basic.I;
-                } else if (i == 630) {
-                    game->basic.S = game->basic.I;
-                    game->basic.T = 45;
-                } else if (i == 635) {
-                    game->basic.S = 45;
-                    game->basic.T = -game->basic.I;
-                } else {
-                    game->basic.S = -game->basic.I;
-                    game->basic.T = -45;
-                }
-                GameBasicReturn(game);
-            }
+// 165 S=R.(8),T=R.(8),A=8*S+T+62;IF@(A)G.165
+// 170 @(A)=I;R.
+//
+static void GameBasicCall165(struct Game *game)
+{
+    uint64_t bits = ~(
+        game->basic.sectorBits[kGameBasicSectorKlingon] | 
+        game->basic.sectorBits[kGameBasicSectorBase] | 
+        game->basic.sectorBits[kGameBasicSectorStar] | 
+        game->basic.sectorBits[kGameBasicSectorEnterprise]
+    );
+
+    // 空きの方が多いので、まず升目を引いて空いていればそれを使う
+    int cell = -1;
+    for (int i = 0; i < kGameBasicSectorPlaceRetry && cell < 0; i++) {
+        int c = GameRandom(game, kGameBasicSectorSize) - 1;
+        if ((bits >> c) & 1) {
+            cell = c;
+        }
+    }
 
-        // ERROR
-        } else {
-            playdate->system->error("%s: %d: illegal basic line: %d.", __FILE__, __LINE__, game->basic.run.line);
+    // 引き当たらなければ空きの n 番目を選ぶ
+    if (cell < 0) {
+        int count = __builtin_popcountll(bits);
+        if (count > 0) {
+            cell = GameBasicSelectBit(bits, GameRandom(game, count) - 1);
         }
     }
+    if (cell >= 0) {
+        game->basic.S = cell / 8 + 1;
+        game->basic.T = cell % 8 + 1;
+        game->basic.A = 8 * game->basic.S + game->basic.T + 62;
+        GameBasicSetAt(game, game->basic.A, game->basic.I);
+    }
+}
+
+// 300 I=@(M+6)-X,J=@(M+12)-Y,S=A*30/(30+I*I+J*J)+1;R.
+//
+static void GameBasicCall300(struct Game *game)
+{
+    game->basic.I = GameBasicGetAt(game, game->basic.M + 6) - game->basic.X;
+    game->basic.J = GameBasicGetAt(game, game->basic.M + 12) - game->basic.Y;
+    game->basic.S = game->combatHits[game->basic.M - 135];
+}
+
+// すべてのクリンゴンについて 300 の S を計算する
+//
+static void GameBasicCombat(struct Game *game)
+{
+    struct Basic *basic = &game->basic;
+    for (int i = 0; i < kGameBasicKlingonSize; i++) {
+        int x = basic->klingonX[i] - basic->X;
+        int y = basic->klingonY[i] - basic->Y;
+#if defined(__ARM_FEATURE_DSP)
+        uint32_t xy = (uint32_t)(uint16_t)x | ((uint32_t)(uint16_t)y << 16);
+        int distance = __smuad(xy, xy);
+#else
+        int distance = x * x + y * y;
+#endif
+        game->combatHits[i] = basic->klingonEnergy[i] != 0 ? game->combatPower[i] * 30 / (30 + distance) + 1 : 0;
+    }
 }
 
 // ゲームを完了する
@@ -1592,6 +2301,68 @@ static void GameDone(struct Game *game)
     ApplicationTransition(kApplicationSceneTitle);
 }
 
+// テキストを消去する
+//
+static void GameTextClear(struct Game *game)
+{
+    game->textLength = 0;
+    game->text[0] = '\0';
+}
+
+// テキストに文字列を追加する
+//
+static void GameTextAppend(struct Game *game, const char *string)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 文字列の追加
+    int length = game->textLength;
+    while (*string != '\0' && length < kGameTextSize - 1) {
+        game->text[length++] = *string++;
+    }
+    game->text[length] = '\0';
+    game->textLength = length;
+
+    // 溢れの確認
+    if (*string != '\0') {
+        playdate->system->error("%s: %d: text is overflowed.", __FILE__, __LINE__);
+    }
+}
+
+// テキストに数値を追加する
+//
+static void GameTextAppendNumber(struct Game *game, int value, int width, char pad)
+{
+    char digits[16];
+    int length = 0;
+    unsigned int n = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[length++] = '0' + n % 10;
+        n /= 10;
+    } while (n > 0);
+    char string[32];
+    int i = 0;
+    int sign = value < 0 ? 1 : 0;
+    if (sign && pad == '0') {
+        string[i++] = '-';
+    }
+    for (int count = length + sign; count < width && i < 16; count++) {
+        string[i++] = pad;
+    }
+    if (sign && pad != '0') {
+        string[i++] = '-';
+    }
+    while (length > 0) {
+        string[i++] = digits[--length];
+    }
+    string[i] = '\0';
+    GameTextAppend(game, string);
+}
+
 // BASIC を処理する
 //
 static void GameBasicNext(struct Game *game)
@@ -1604,11 +2375,19 @@ static void GameBasicBack(struct Game *game)
 }
 static void GameBasicGoto(struct Game *game, int line)
 {
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate != NULL && GameBasicFind(line) == NULL) {
+        playdate->system->error("%s: %d: illegal basic line: %d -> %d.", __FILE__, __LINE__, game->basic.run.line, line);
+    }
     game->basic.run.line = line;
     game->basic.run.sentence = 0;
 }
 static void GameBasicGosub(struct Game *game, int line)
 {
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate != NULL && GameBasicFind(line) == NULL) {
+        playdate->system->error("%s: %d: illegal basic line: %d -> %d.", __FILE__, __LINE__, game->basic.run.line, line);
+    }
     if (game->basic.returnStack < kGameBasicReturnSize) {
         game->basic.returns[game->basic.returnStack].line = game->basic.run.line;
         game->basic.returns[game->basic.returnStack].sentence = game->basic.run.sentence + 1;
@@ -1626,6 +2405,206 @@ static void GameBasicReturn(struct Game *game)
     }
 }
 
+// BASIC の行を作成する
+//
+static void GameBasicBuild(void)
+{
+    for (int i = 0; i < kGameBasicLineSize; i++) {
+        gameBasicFunctions[i] = NULL;
+    }
+    for (int i = 0; i < (int)(sizeof (gameBasicLines) / sizeof (struct GameBasicLine)); i++) {
+        gameBasicFunctions[gameBasicLines[i].line] = gameBasicLines[i].function;
+    }
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            uint64_t bits = 0;
+            for (int y = (i > 0 ? i - 1 : i); y <= (i < 7 ? i + 1 : i); y++) {
+                for (int x = (j > 0 ? j - 1 : j); x <= (j < 7 ? j + 1 : j); x++) {
+                    bits |= (uint64_t)1 << (y * 8 + x);
+                }
+            }
+            gameBasicSectorNeighbours[i * 8 + j] = bits;
+        }
+    }
+}
+
+// BASIC の配列を参照する
+//
+static int GameBasicGetAt(struct Game *game, int index)
+{
+    return BasicGetAt(&game->basic, index);
+}
+static void GameBasicSetAt(struct Game *game, int index, int value)
+{
+    BasicSetAt(&game->basic, index, value);
+    if (index < kGameBasicArrayGalaxy) {
+        ;
+    } else if (index < kGameBasicArrayDamage) {
+        GameBasicTouch(game, kGameVersionGalaxy);
+    } else if (index < kGameBasicArraySector) {
+        GameBasicTouch(game, kGameVersionDamage);
+    } else if (index < kGameBasicArrayKlingonEnergy) {
+        GameBasicTouch(game, kGameVersionSector);
+    }
+}
+
+// 状態が書き換えられた領域の版数を進める
+//
+static void GameBasicTouch(struct Game *game, int region)
+{
+    ++game->versions[region];
+}
+
+// n 番目（0 から）に立っているビットの位置を取得する
+//
+static int GameBasicSelectBit(uint64_t bits, int n)
+{
+    int base = 0;
+    for (int count = __builtin_popcount((uint32_t)(bits & 0xff)); n >= count; count = __builtin_popcount((uint32_t)(bits & 0xff))) {
+        n -= count;
+        bits >>= 8;
+        base += 8;
+    }
+    while (n-- > 0) {
+        bits &= bits - 1;
+    }
+    return base + __builtin_ctzll(bits);
+}
+
+// コースの軌跡を取得する
+//
+static const struct GameBasicCourse *GameBasicGetCourse(int course)
+{
+    if (course < 0 || course >= kGameBasicCourseSize) {
+        course = 0;
+    }
+    struct GameBasicCourse *c = &gameBasicCourses[course];
+    if (!c->built) {
+
+        // 620 - 640 と同じく 1 ステップの移動量を求める
+        int s = (course + 45) / 90;
+        int i = course - s * 90;
+        int dx = -45;
+        int dy = i;
+        if (s == 1) {
+            dx = i;
+            dy = 45;
+        } else if (s == 2) {
+            dx = 45;
+            dy = -i;
+        } else if (s == 3) {
+            dx = -i;
+            dy = -45;
+        }
+
+        // (45*X+22+m*S)/45 = X+floor((22+m*S)/45) なので開始位置によらない
+        for (int m = 1; m <= kGameBasicCourseStep; m++) {
+            int x = 22 + m * dx;
+            int y = 22 + m * dy;
+            c->steps[m - 1][0] = (int8_t)(x >= 0 ? x / 45 : -((-x + 44) / 45));
+            c->steps[m - 1][1] = (int8_t)(y >= 0 ? y / 45 : -((-y + 44) / 45));
+        }
+        c->built = true;
+    }
+    return c;
+}
+
+// BASIC の行を検索する
+//
+static GameFunction GameBasicFind(int line)
+{
+    return line >= 0 && line < kGameBasicLineSize ? gameBasicFunctions[line] : NULL;
+}
+
+// BASIC のプログラムを翻訳する
+//
+static void GameBasicCompile(struct Game *game)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // ファイルの読み込み
+    char *source = NULL;
+    int length = 0;
+    FileStat stat;
+    if (playdate->file->stat(gameBasicProgramPath, &stat) == 0) {
+        source = playdate->system->realloc(NULL, stat.size);
+        if (source != NULL) {
+            SDFile *file = playdate->file->open(gameBasicProgramPath, kFileRead);
+            if (file != NULL) {
+                length = playdate->file->read(file, source, stat.size);
+                playdate->file->close(file);
+            }
+        }
+    }
+    if (source == NULL || length <= 0) {
+        playdate->system->error("%s: %d: basic program is not loaded: %s.", __FILE__, __LINE__, gameBasicProgramPath);
+    } else {
+
+        // プログラムの翻訳
+        game->program = playdate->system->realloc(game->program, sizeof (struct BasicProgram));
+        if (game->program == NULL) {
+            playdate->system->error("%s: %d: basic program is not allocated.", __FILE__, __LINE__);
+        } else if (!BasicCompile(game->program, source, length)) {
+            playdate->system->error("%s: %d: basic program is not compiled: %d at line %d.", __FILE__, __LINE__, game->program->error, game->program->errorLine);
+            playdate->system->realloc(game->program, 0);
+            game->program = NULL;
+        }
+    }
+
+    // ソースの解放
+    if (source != NULL) {
+        playdate->system->realloc(source, 0);
+    }
+}
+
+// IN. の入力を開始する
+//
+static void GameBasicOpenInput(struct Game *game)
+{
+    const struct GameBasicInput *input = GameBasicFindInput(game->basic.run.line);
+    if (input->widget == kGameBasicInputMenu) {
+        ConsoleOpenMenu(input->items, input->size);
+    } else if (input->widget == kGameBasicInputAngle) {
+        ConsoleInputAngle();
+    } else {
+        ConsoleInputNumber(input->minimum > 1 ? input->minimum : 1, input->minimum, input->maximum);
+    }
+}
+
+// IN. の入力を変数に書き込む
+//
+static void GameBasicCloseInput(struct Game *game)
+{
+    const struct GameBasicInput *input = GameBasicFindInput(game->basic.run.line);
+    int value;
+    if (input->widget == kGameBasicInputMenu) {
+        int selected = ConsoleGetSelectedMenu();
+        value = selected >= 0 && selected < input->size ? BasicGetVariable(&game->basic, input->letters[selected] - 'A') : 0;
+    } else if (input->widget == kGameBasicInputAngle) {
+        value = ConsoleGetInputedAngle();
+    } else {
+        value = ConsoleGetInputedNumber();
+    }
+    BasicSetVariable(&game->basic, game->machine.input, value);
+    game->machine.input = -1;
+}
+
+// IN. の入力を検索する
+//
+static const struct GameBasicInput *GameBasicFindInput(int line)
+{
+    for (int i = 0; i < (int)(sizeof (gameBasicInputs) / sizeof (gameBasicInputs[0])); i++) {
+        if (gameBasicInputs[i].line == line) {
+            return &gameBasicInputs[i];
+        }
+    }
+    return &gameBasicInputDefault;
+}
+
 // ゲームがクラシックかどうかを判定する
 //
 bool GameIsClassic(void)
@@ -1639,27 +2618,44 @@ bool GameIsClassic(void)
 bool GameIsShortRangeSensorAvilable(void)
 {
     struct Game *game = (struct Game *)SceneGetUserdata();
-    return game != NULL && game->basic.at[1 + 63] == 0 ? true : false;
+    return game != NULL && game->basic.damage[1 - 1] == 0 ? true : false;
 }
 bool GameIsLongRangeSensorAvilable(void)
 {
     struct Game *game = (struct Game *)SceneGetUserdata();
-    return game != NULL && game->basic.at[3 + 63] == 0 ? true : false;
+    return game != NULL && game->basic.damage[3 - 1] == 0 ? true : false;
 }
 bool GameIsComputerDisplayAvilable(void)
 {
     struct Game *game = (struct Game *)SceneGetUserdata();
-    return game != NULL && game->basic.at[2 + 63] == 0 ? true : false;
+    return game != NULL && game->basic.damage[2 - 1] == 0 ? true : false;
+}
+
+// 損傷が前に調べてから書き換えられたかどうかを判定する
+//
+bool GameIsDamageUpdated(void)
+{
+    struct Game *game = (struct Game *)SceneGetUserdata();
+    if (game == NULL || game->printedVersions[kGameVersionDamage] == game->versions[kGameVersionDamage]) {
+        return false;
+    }
+    game->printedVersions[kGameVersionDamage] = game->versions[kGameVersionDamage];
+    return true;
 }
 
 // 地図なしを描画する
 //
-void GamePrintNoMap(LCDBitmap *bitmap)
+bool GamePrintNoMap(LCDBitmap *bitmap, bool redraw)
 {
     // Playdate の取得
     PlaydateAPI *playdate = IocsGetPlaydate();
     if (playdate == NULL) {
-        return;
+        return false;
+    }
+
+    // 描画済みなら何もしない
+    if (!redraw) {
+        return false;
     }
 
     // 幅の取得
@@ -1690,24 +2686,34 @@ void GamePrintNoMap(LCDBitmap *bitmap)
 
     // 描画の完了
     playdate->graphics->popContext();
+    return true;
 }
 
 // 銀河系地図を描画する
 //
-void GamePrintGalaxyMap(LCDBitmap *bitmap)
+bool GamePrintGalaxyMap(LCDBitmap *bitmap, bool redraw)
 {
     // Playdate の取得
     PlaydateAPI *playdate = IocsGetPlaydate();
     if (playdate == NULL) {
-        return;
+        return false;
     }
 
     // ゲームの取得
     struct Game *game = (struct Game *)SceneGetUserdata();
     if (game == NULL) {
-        return;
+        return false;
     }
 
+    // 描画してから銀河系が書き換えられていなければ何もしない
+    if (!redraw && game->printedVersions[kGameVersionGalaxy] == game->versions[kGameVersionGalaxy]) {
+        return false;
+    }
+    game->printedVersions[kGameVersionGalaxy] = game->versions[kGameVersionGalaxy];
+
+    // 現在の象限の取得
+    int quadrant = (game->basic.U - 1) * 8 + (game->basic.V - 1);
+
     // 幅の取得
     int width0 = IocsGetTextWidth(kIocsFontJapanese, "9");
     int width1 = IocsGetTextWidth(kIocsFontMini, "9");
@@ -1721,12 +2727,12 @@ void GamePrintGalaxyMap(LCDBitmap *bitmap)
 
     // 描画の開始
     playdate->graphics->pushContext(bitmap);
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->clearBitmap(bitmap, kColorBlack);
 
     // タイトルの描画
-    {
+    if (redraw) {
         char *text = "GALAXY MAP";
+        playdate->graphics->setDrawMode(kDrawModeCopy);
+        playdate->graphics->clearBitmap(bitmap, kColorBlack);
         IocsSetFont(kIocsFontMini);
         playdate->graphics->setDrawMode(kDrawModeFillWhite);
         playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x, 0 * height0 + 0 * height1);
@@ -1734,56 +2740,87 @@ void GamePrintGalaxyMap(LCDBitmap *bitmap)
         playdate->graphics->drawLine(x, 0 * height0 + 1 * height1, x + 33 * width0 - 1 * width1, 0 * height0 + 1 * height1, 1, kColorWhite);
     }
 
-    // マップの描画
+    // マップの描画（値か強調が変わった象限だけを描き直す）
+    bool updated = redraw;
     {
         IocsSetFont(kIocsFontJapanese);
         for (int i = 0; i < 8; i++) {
             for (int j = 0; j < 8; j++) {
+                int k = i * 8 + j;
+                int m = game->basic.galaxy[k];
+                bool here = k == quadrant ? true : false;
+                bool left = j > 0 && k - 1 == quadrant ? true : false;
+                if (
+                    !redraw && 
+                    m == game->galaxyShadow[k] && 
+                    here == (k == game->galaxyShadowQuadrant) && 
+                    left == (j > 0 && k - 1 == game->galaxyShadowQuadrant)
+                ) {
+                    continue;
+                }
                 int x = (j * 4) * width0;
                 int y = (i + 1) * height0;
-                if (game->basic.U - 1 == i && game->basic.V - 1 == j) {
-                    playdate->graphics->setDrawMode(kDrawModeCopy);
+
+                // 象限の消去（強調は右隣の象限の先頭の空白にはみ出す）
+                playdate->graphics->setDrawMode(kDrawModeCopy);
+                playdate->graphics->fillRect(x, y, 4 * width0, height0, kColorBlack);
+                if (here) {
                     playdate->graphics->fillRect(x, y, 5 * width0, height0, kColorWhite);
+                } else if (left) {
+                    playdate->graphics->fillRect(x, y, 1 * width0, height0, kColorWhite);
                 }
-                int m = game->basic.at[i * 8 + j];
+
+                // 値の描画
+                char text[5] = { ' ', '.', '.', '.', '\0', };
                 if (m > 0) {
-                    char *text;
-                    playdate->system->formatString(&text, " %03d", m);
-                    playdate->graphics->setDrawMode(kDrawModeXOR);
-                    playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x, y);
-                    playdate->system->realloc(text, 0);
-                } else if (game->basic.U - 1 == i && game->basic.V - 1 == j) {
-                    char *text = " ???";
-                    playdate->graphics->setDrawMode(kDrawModeXOR);
-                    playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x, y);
-                } else {
-                    char *text = " ...";
-                    playdate->graphics->setDrawMode(kDrawModeXOR);
-                    playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x, y);
+                    text[1] = '0' + (m / 100) % 10;
+                    text[2] = '0' + (m / 10) % 10;
+                    text[3] = '0' + m % 10;
+                } else if (here) {
+                    text[1] = text[2] = text[3] = '?';
                 }
+                playdate->graphics->setDrawMode(kDrawModeXOR);
+                playdate->graphics->drawText(text, 4, kUTF8Encoding, x, y);
+                updated = true;
             }
         }
     }
 
+    // 描画した内容の保存
+    memcpy(game->galaxyShadow, game->basic.galaxy, sizeof (game->galaxyShadow));
+    game->galaxyShadowQuadrant = quadrant;
+
     // 描画の完了
     playdate->graphics->popContext();
+    return updated;
 }
 
 // セクター地図を描画する
 //
-void GamePrintSectorMap(LCDBitmap *bitmap)
+bool GamePrintSectorMap(LCDBitmap *bitmap, bool redraw)
 {
     // Playdate の取得
     PlaydateAPI *playdate = IocsGetPlaydate();
     if (playdate == NULL) {
-        return;
+        return false;
     }
 
     // ゲームの取得
     struct Game *game = (struct Game *)SceneGetUserdata();
     if (game == NULL) {
-        return;
+        return false;
+    }
+
+    // タイルがない
+    if (game->sectorSheet == NULL) {
+        return false;
+    }
+
+    // 描画してからセクターが書き換えられていなければ何もしない
+    if (!redraw && game->printedVersions[kGameVersionSector] == game->versions[kGameVersionSector]) {
+        return false;
     }
+    game->printedVersions[kGameVersionSector] = game->versions[kGameVersionSector];
 
     // 幅の取得
     int width0 = IocsGetTextWidth(kIocsFontJapanese, "9");
@@ -1798,12 +2835,12 @@ void GamePrintSectorMap(LCDBitmap *bitmap)
 
     // 描画の開始
     playdate->graphics->pushContext(bitmap);
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->clearBitmap(bitmap, kColorBlack);
 
     // タイトルの描画
-    {
+    if (redraw) {
         char *text = "SECTOR MAP";
+        playdate->graphics->setDrawMode(kDrawModeCopy);
+        playdate->graphics->clearBitmap(bitmap, kColorBlack);
         IocsSetFont(kIocsFontMini);
         playdate->graphics->setDrawMode(kDrawModeFillWhite);
         playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x, 0 * height0 + 0 * height1);
@@ -1811,45 +2848,79 @@ void GamePrintSectorMap(LCDBitmap *bitmap)
         playdate->graphics->drawLine(x, 0 * height0 + 1 * height1, x + 33 * width0 - 1 * width1, 0 * height0 + 1 * height1, 1, kColorWhite);
     }
 
-    // マップの描画
+    // マップの描画（変わったマスだけタイルを転送する）
+    bool updated = redraw;
     {
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->setDrawMode(kDrawModeFillWhite);
+        playdate->graphics->setDrawMode(kDrawModeCopy);
         for (int i = 1; i <= 8; i++) {
             for (int j = 1; j <= 8; j++) {
+                int k = (i - 1) * 8 + (j - 1);
+                int shift = (k & 1) * 4;
+                int m = (game->basic.sector[k >> 1] >> shift) & 0x0f;
+                if (!redraw && m == ((game->sectorShadow[k >> 1] >> shift) & 0x0f)) {
+                    continue;
+                }
                 int x = ((j - 1) * 2 + 9) * width0;
                 int y = ((i - 1) + 1) * height0;
-                int m = game->basic.at[i * 8 + j + 62];
-                static char *texts[] = {
-                    ".", 
-                    "K", 
-                    "B", 
-                    "*", 
-                    "E", 
-                };
-                playdate->graphics->drawText(texts[m], strlen(texts[m]), kUTF8Encoding, x, y);
+                if (m < kGameBasicSectorTypeSize) {
+                    playdate->graphics->setClipRect(x, y, 2 * width0, height0);
+                    playdate->graphics->drawBitmap(game->sectorSheet, x - m * 2 * width0, y, kBitmapUnflipped);
+                }
+                updated = true;
             }
         }
+        playdate->graphics->clearClipRect();
     }
+    memcpy(game->sectorShadow, game->basic.sector, sizeof (game->sectorShadow));
 
     // 描画の完了
     playdate->graphics->popContext();
+    return updated;
 }
 
 // レポートを描画する
 //
-void GamePrintReport(LCDBitmap *bitmap)
+bool GamePrintReport(LCDBitmap *bitmap, bool redraw)
 {
     // Playdate の取得
     PlaydateAPI *playdate = IocsGetPlaydate();
     if (playdate == NULL) {
-        return;
+        return false;
     }
 
     // ゲームの取得
     struct Game *game = (struct Game *)SceneGetUserdata();
     if (game == NULL) {
-        return;
+        return false;
+    }
+
+    // 描画してから状態が書き換えられていなければ何もしない
+    if (!redraw && game->printedVersions[kGameVersionStatus] == game->versions[kGameVersionStatus]) {
+        return false;
+    }
+    game->printedVersions[kGameVersionStatus] = game->versions[kGameVersionStatus];
+
+    // 各行の値の取得
+    int values[kGameReportRowSize];
+    values[kGameReportStardate] = 3230 - game->basic.D;
+    values[kGameReportTimeLeft] = game->basic.D;
+    if (game->basic.O != 0) {
+        values[kGameReportCondition] = 0;
+    } else if (game->basic.N != 0) {
+        values[kGameReportCondition] = 1;
+    } else if (game->basic.E < 999) {
+        values[kGameReportCondition] = 2;
+    } else {
+        values[kGameReportCondition] = 3;
+    }
+    values[kGameReportEnergy] = game->basic.E;
+    values[kGameReportTorpedoes] = game->basic.F;
+    values[kGameReportKlingons] = game->basic.K;
+    values[kGameReportStarbases] = game->basic.B;
+
+    // 描画済みの内容から変化がなければ何もしない
+    if (!redraw && memcmp(values, game->reportShadow, sizeof (values)) == 0) {
+        return false;
     }
 
     // 幅の取得
@@ -1862,93 +2933,75 @@ void GamePrintReport(LCDBitmap *bitmap)
 
     // 横の取得
     int x0 = 0;
-    int x1 = width - IocsGetTextWidth(kIocsFontJapanese, "999999");
 
     // 描画の開始
     playdate->graphics->pushContext(bitmap);
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->clearBitmap(bitmap, kColorBlack);
-    playdate->graphics->setDrawMode(kDrawModeFillWhite);
 
     // タイトルの描画
-    {
+    if (redraw) {
         char *text = "STATUS";
+        playdate->graphics->setDrawMode(kDrawModeCopy);
+        playdate->graphics->clearBitmap(bitmap, kColorBlack);
+        playdate->graphics->setDrawMode(kDrawModeFillWhite);
         IocsSetFont(kIocsFontMini);
         playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 0 * height0 + 0 * height1);
         // playdate->graphics->drawText(border, strlen(border), kUTF8Encoding, x0, 0 * height0 + 1 * height1);
         playdate->graphics->drawLine(x0, 0 * height0 + 1 * height1, x0 + width - 1, 0 * height0 + 1 * height1, 1, kColorWhite);
     }
 
-    // STARDATE の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "STARDATE  %d", 3230 - game->basic.D);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 1 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
-    }
-
-    // TIME LEFT の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "TIMELEFT  %d", game->basic.D);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 2 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
-    }
-
-    // CONDITION の描画
-    {
-        char *text = NULL;
-        if (game->basic.O != 0) {
-            text = "CONDITION DOCKED";
-        } else if (game->basic.N != 0) {
-            text = "CONDITION RED";
-        } else if (game->basic.E < 999) {
-            text = "CONDITION YELLOW";
+    // 値の変わった行の描画
+    IocsSetFont(kIocsFontJapanese);
+    for (int i = 0; i < kGameReportRowSize; i++) {
+        if (!redraw && values[i] == game->reportShadow[i]) {
+            continue;
+        }
+        static const char *labels[] = {
+            "STARDATE  ", 
+            "TIMELEFT  ", 
+            NULL, 
+            "ENERGY    ", 
+            "TORPEDOES ", 
+            "KLINGONS  ", 
+            "STARBASES ", 
+        };
+        static const char *conditions[] = {
+            "CONDITION DOCKED", 
+            "CONDITION RED", 
+            "CONDITION YELLOW", 
+            "CONDITION GREEN", 
+        };
+        char text[32];
+        int length = 0;
+        if (i == kGameReportCondition) {
+            length = strlen(conditions[values[i]]);
+            memcpy(text, conditions[values[i]], length);
         } else {
-            text = "CONDITION GREEN";
+            length = strlen(labels[i]);
+            memcpy(text, labels[i], length);
+            int value = values[i];
+            if (value < 0) {
+                text[length++] = '-';
+                value = -value;
+            }
+            char digits[12];
+            int digit = 0;
+            do {
+                digits[digit++] = '0' + value % 10;
+                value /= 10;
+            } while (value > 0);
+            while (digit > 0) {
+                text[length++] = digits[--digit];
+            }
         }
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 3 * height0 + 0 * height1);
-    }
-
-    // ENERGY の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "ENERGY    %d", game->basic.E);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 4 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
-    }
-
-    // TORPEDOES の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "TORPEDOES %d", game->basic.F);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 5 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
-    }
-
-    // KLINGONS LEFT の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "KLINGONS  %d", game->basic.K);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 6 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
-    }
-
-    // STARBASES の描画
-    {
-        char *text;
-        playdate->system->formatString(&text, "STARBASES %d", game->basic.B);
-        IocsSetFont(kIocsFontJapanese);
-        playdate->graphics->drawText(text, strlen(text), kUTF8Encoding, x0, 7 * height0 + 0 * height1);
-        playdate->system->realloc(text, 0);
+        int y = (i + 1) * height0 + 0 * height1;
+        playdate->graphics->setDrawMode(kDrawModeCopy);
+        playdate->graphics->fillRect(x0, y, width, height0, kColorBlack);
+        playdate->graphics->setDrawMode(kDrawModeFillWhite);
+        playdate->graphics->drawText(text, length, kUTF8Encoding, x0, y);
     }
+    memcpy(game->reportShadow, values, sizeof (values));
 
     // 描画の完了
     playdate->graphics->popContext();
+    return true;
 }
@@ -6,65 +6,57 @@
 //
 #include <stdbool.h>
 #include "pd_api.h"
+#include "Basic.h"
 
 
 // Tiny Basic
 //
 enum {
-    kGameBasicArraySize = 1024, 
+    kGameBasicSectorPlaceRetry = 4, 
 };
 enum {
-    kGameBasicReturnSize = 16, 
+    kGameBasicStepDefault = 256, 
+    kGameBasicMachineStep = 4096, 
 };
-struct Pointer {
+
+// ゲーム関数
+//
+typedef void (*GameFunction)(void *game);
+
+// Tiny Basic の行
+//
+struct GameBasicLine {
     int line;
-    int sentence;
+    GameFunction function;
 };
-struct Basic {
-
-    // 変数
-    int A;
-    int B;
-    int C;
-    int D;
-    int E;
-    int F;
-    int G;
-    int H;
-    int I;
-    int J;
-    int K;
-    int L;
-    int M;
-    int N;
-    int O;
-    int P;
-    int Q;
-    int R;
-    int S;
-    int T;
-    int U;
-    int V;
-    int W;
-    int X;
-    int Y;
-    int Z;
-
-    // 配列
-    int at[kGameBasicArraySize];
-
-    // 実行
-    struct Pointer run;
-
-    // GOSUB - RETURN
-    struct Pointer returns[kGameBasicReturnSize];
-    int returnStack;
 
+// Tiny Basic のコースの軌跡
+//
+enum {
+    kGameBasicCourseSize = 361, 
+    kGameBasicCourseStep = 8, 
+};
+struct GameBasicCourse {
+    bool built;
+    int8_t steps[kGameBasicCourseStep][2];
 };
 
-// ゲーム関数
+// Tiny Basic の入力（仮想機械の IN. をウィジェットに置き換える）
 //
-typedef void (*GameFunction)(void *game);
+enum {
+    kGameBasicInputMenu = 0, 
+    kGameBasicInputNumber, 
+    kGameBasicInputAngle, 
+};
+struct GameBasicInput {
+    int line;
+    int widget;
+    const char **items;
+    const char *letters;
+    int size;
+    int minimum;
+    int maximum;
+};
 
 // テキスト
 //
@@ -72,6 +64,29 @@ enum {
     kGameTextSize = 1024, 
 };
 
+// 版数
+//
+enum {
+    kGameVersionGalaxy = 0, 
+    kGameVersionSector, 
+    kGameVersionStatus, 
+    kGameVersionDamage, 
+    kGameVersionSize, 
+};
+
+// レポート
+//
+enum {
+    kGameReportStardate = 0, 
+    kGameReportTimeLeft, 
+    kGameReportCondition, 
+    kGameReportEnergy, 
+    kGameReportTorpedoes, 
+    kGameReportKlingons, 
+    kGameReportStarbases, 
+    kGameReportRowSize, 
+};
+
 // ゲーム
 //
 struct Game {
@@ -85,8 +100,37 @@ struct Game {
     // Tiny Basic
     struct Basic basic;
 
+    // 1 フレームあたりの BASIC の実行数
+    int basicStep;
+
+    // .bas を翻訳したプログラムと仮想機械（クラシック）
+    struct BasicProgram *program;
+    struct BasicMachine machine;
+
+    // 乱数
+    uint32_t random[4];
+
+    // コース
+    int course;
+
+    // 戦闘（クリンゴンごとの攻撃力と被害）
+    int combatPower[kGameBasicKlingonSize];
+    int combatHits[kGameBasicKlingonSize];
+
     // テキスト
     char text[kGameTextSize];
+    int textLength;
+
+    // 版数（状態の領域ごとの書き換え回数と描画済みの回数）
+    unsigned int versions[kGameVersionSize];
+    unsigned int printedVersions[kGameVersionSize];
+
+    // 地図の表示（描画済みの内容）
+    int16_t galaxyShadow[kGameBasicGalaxySize];
+    int galaxyShadowQuadrant;
+    uint8_t sectorShadow[kGameBasicSectorSize / 2];
+    LCDBitmap *sectorSheet;
+    int reportShadow[kGameReportRowSize];
 
     // クラシック
     bool classic;
@@ -140,8 +184,9 @@ extern bool GameIsClassic(void);
 extern bool GameIsShortRangeSensorAvilable(void);
 extern bool GameIsLongRangeSensorAvilable(void);
 extern bool GameIsComputerDisplayAvilable(void);
-extern void GamePrintNoMap(LCDBitmap *bitmap);
-extern void GamePrintGalaxyMap(LCDBitmap *bitmap);
-extern void GamePrintSectorMap(LCDBitmap *bitmap);
-extern void GamePrintReport(LCDBitmap *bitmap);
+extern bool GameIsDamageUpdated(void);
+extern bool GamePrintNoMap(LCDBitmap *bitmap, bool redraw);
+extern bool GamePrintGalaxyMap(LCDBitmap *bitmap, bool redraw);
+extern bool GamePrintSectorMap(LCDBitmap *bitmap, bool redraw);
+extern bool GamePrintReport(LCDBitmap *bitmap, bool redraw);
 
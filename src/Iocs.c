@@ -15,6 +15,10 @@
 static void IocsInitializeFont(void);
 static void IocsInitializeScreen(void);
 static void IocsInitializeButton(void);
+static void IocsResume(void);
+static void IocsSetFrameRate(int rate);
+static void IocsClipDirty(void);
+static bool IocsIsBandCovered(int order, int top, int bottom, int left, int right);
 static void IocsUpdateButton(void);
 static void IocsPrintButton(int x, int y, PDButtons button);
 static void IocsInitializeCrank(void);
@@ -55,6 +59,11 @@ void IocsInitialize(PlaydateAPI *playdate)
 
     // フレームレートの設定
     playdate->display->setRefreshRate(kIocsFrameRate);
+    iocs->frameDelta = 0.0f;
+    iocs->frameRate = kIocsFrameRate;
+    iocs->frameBoost = 0.0f;
+    iocs->lowPower = false;
+    playdate->system->resetElapsedTime();
 
     // フォントの初期化
     IocsInitializeFont();
@@ -111,6 +120,7 @@ void IocsEventHandler(PDSystemEvent event, uint32_t arg)
     // kEventUnlock: アンロック
     } else if (event == kEventUnlock) {
 		playdate->system->logToConsole("%s: %d: kEventUnlock.", __FILE__, __LINE__);
+        IocsResume();
 
     // kEventPause: 一時停止
     } else if (event == kEventPause) {
@@ -119,6 +129,7 @@ void IocsEventHandler(PDSystemEvent event, uint32_t arg)
     // kEventResume: 一時停止からの復帰
     } else if (event == kEventResume) {
 		playdate->system->logToConsole("%s: %d: kEventResume.", __FILE__, __LINE__);
+        IocsResume();
 
     // kEventTerminate: 停止
     } else if (event == kEventTerminate) {
@@ -135,6 +146,8 @@ void IocsEventHandler(PDSystemEvent event, uint32_t arg)
     // kEventLowPower: 電力低下
     } else if (event == kEventLowPower) {
 		playdate->system->logToConsole("%s: %d: kEventLowPowern.", __FILE__, __LINE__);
+        iocs->lowPower = true;
+        IocsSetFrameRate(kIocsFrameRate);
 
     }
 }
@@ -149,6 +162,10 @@ void IocsUpdateBegin(void)
         return;
     }
 
+    // 経過時間の更新
+    iocs->frameDelta = playdate->system->getElapsedTime();
+    playdate->system->resetElapsedTime();
+
     // ボタンの更新
     IocsUpdateButton();
 
@@ -176,17 +193,80 @@ void IocsUpdateEnd(void)
     IocsPrintCrank( 1, 1, iocs->crankAngle);
     IocsPrintCrank(81, 1, iocs->crankChange);
     */
+
+    // フレームレートの調整（クランクを回している間と要求から少しの間は上げる、電力低下中は上げない）
+    {
+        if (iocs->crankChange != 0.0f) {
+            IocsBoostFrameRate();
+        } else if (iocs->frameBoost > 0.0f) {
+            iocs->frameBoost -= iocs->frameDelta;
+        }
+        IocsSetFrameRate(iocs->frameBoost > 0.0f && !iocs->lowPower ? kIocsFrameRateBoost : kIocsFrameRate);
+    }
+}
+
+// 一時停止から復帰する
+//
+static void IocsResume(void)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 停止中の経過時間を捨てる
+    playdate->system->resetElapsedTime();
+    IocsMarkDirtyAll();
+
+    // 電池が戻っていれば電力低下を解く
+    if (iocs->lowPower && playdate->system->getBatteryPercentage() > (float)kIocsFrameLowPowerPercentage) {
+        iocs->lowPower = false;
+    }
+}
+
+// フレームレートを設定する
+//
+static void IocsSetFrameRate(int rate)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 変わったときだけ設定する
+    if (rate != iocs->frameRate) {
+        playdate->display->setRefreshRate(rate);
+        iocs->frameRate = rate;
+    }
+}
+
+// フレームレートを一時的に上げる
+//
+void IocsBoostFrameRate(void)
+{
+    if (iocs != NULL) {
+        iocs->frameBoost = (float)kIocsFrameBoostMillisecond / 1000.0f;
+    }
 }
 
 // フレームレートを取得する
 //
 int IocsGetFrameRate(void)
 {
-    return kIocsFrameRate;
+    return iocs != NULL ? iocs->frameRate : kIocsFrameRate;
 }
 int IocsGetFrameMillisecond(void)
 {
-    return kIocsFrameMillisecond;
+    return 1000 / IocsGetFrameRate();
+}
+
+// 前のフレームからの経過時間を取得する
+//
+float IocsGetFrameDelta(void)
+{
+    return iocs != NULL ? iocs->frameDelta : 0.0f;
 }
 
 // フォントを初期化する
@@ -207,6 +287,28 @@ static void IocsInitializeFont(void)
             playdate->system->error("%s: %d: font is not loaded:  %s: %s", __FILE__, __LINE__, fontPaths[i], error);
             return;
         }
+        iocs->fontHeights[i] = playdate->graphics->getFontHeight(iocs->fonts[i]);
+    }
+
+    // グリフのキャッシュ
+    for (int i = 0; i < kIocsFontSize; i++) {
+        for (int c = 0; c < kIocsGlyphSize; c++) {
+            iocs->glyphBitmaps[i][c] = NULL;
+            iocs->glyphAdvances[i][c] = 0;
+            iocs->glyphCached[i][c] = false;
+            if (c >= ' ' && c < 0x7f) {
+                LCDFontPage *page = playdate->graphics->getFontPage(iocs->fonts[i], c);
+                if (page != NULL) {
+                    LCDBitmap *bitmap = NULL;
+                    int advance = 0;
+                    if (playdate->graphics->getPageGlyph(page, c, &bitmap, &advance) != NULL) {
+                        iocs->glyphBitmaps[i][c] = bitmap;
+                        iocs->glyphAdvances[i][c] = (int8_t)advance;
+                        iocs->glyphCached[i][c] = true;
+                    }
+                }
+            }
+        }
     }
 }
 
@@ -235,7 +337,7 @@ int IocsGetFontHeight(IocsFont font)
     }
 
     // フォントの高さの取得
-    return playdate->graphics->getFontHeight(iocs->fonts[font]);
+    return iocs->fontHeights[font];
 }
 
 // テキストの幅を取得する
@@ -252,6 +354,19 @@ int IocsGetTextWidth(IocsFont font, const char *text)
     return playdate->graphics->getTextWidth(iocs->fonts[font], text, strlen(text), kUTF8Encoding, 0);
 }
 
+// キャッシュされたグリフを取得する
+//
+bool IocsGetGlyph(IocsFont font, char c, LCDBitmap **bitmap, int *advance)
+{
+    unsigned char code = (unsigned char)c;
+    if (iocs == NULL || code >= kIocsGlyphSize || !iocs->glyphCached[font][code]) {
+        return false;
+    }
+    *bitmap = iocs->glyphBitmaps[font][code];
+    *advance = iocs->glyphAdvances[font][code];
+    return true;
+}
+
 
 // 画面を初期化する
 //
@@ -271,6 +386,15 @@ static void IocsInitializeScreen(void)
 
     // 画面の初期化
     iocs->screenColor = kColorWhite;
+
+    // 更新行の初期化（最初は画面全体を描画する）
+    iocs->dirtyTop = 0;
+    iocs->dirtyBottom = LCD_ROWS;
+
+    // パネルの初期化
+    for (int i = 0; i < kIocsPanelSize; i++) {
+        IocsResetPanel(i);
+    }
 }
 
 // 画面の色を設定する
@@ -291,13 +415,211 @@ void IocsClearScreen(void)
         return;
     }
 
-    // 画面のクリア
+    // 画面のクリア（不透明なパネルで覆われる行は消去しない）
     playdate->graphics->setDrawMode(kDrawModeCopy);
     playdate->graphics->setDrawOffset(0, 0);
-    playdate->graphics->clearClipRect();
+    IocsClipDirty();
     if (iocs->screenColor != kColorClear) {
-        playdate->graphics->clear(iocs->screenColor);
+        int tops[kIocsPanelSpanSize];
+        int bottoms[kIocsPanelSpanSize];
+        int count = IocsGetVisibleRows(-1, 0, 0, LCD_COLUMNS, LCD_ROWS, tops, bottoms, kIocsPanelSpanSize);
+        if (count == 1 && tops[0] == 0 && bottoms[0] == LCD_ROWS) {
+            playdate->graphics->clear(iocs->screenColor);
+        } else {
+            for (int i = 0; i < count; i++) {
+                playdate->graphics->fillRect(0, tops[i], LCD_COLUMNS, bottoms[i] - tops[i], iocs->screenColor);
+            }
+        }
+    }
+}
+
+// 更新行で描画を切り取る
+//
+static void IocsClipDirty(void)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 切り取りの設定
+    if (iocs->dirtyTop <= 0 && iocs->dirtyBottom >= LCD_ROWS) {
+        playdate->graphics->clearClipRect();
+    } else if (iocs->dirtyTop < iocs->dirtyBottom) {
+        playdate->graphics->setClipRect(0, iocs->dirtyTop, LCD_COLUMNS, iocs->dirtyBottom - iocs->dirtyTop);
+    }
+}
+
+// 更新行を設定する
+//
+void IocsMarkDirty(int y, int height)
+{
+    int top = y < 0 ? 0 : y;
+    int bottom = y + height > LCD_ROWS ? LCD_ROWS : y + height;
+    if (iocs != NULL && top < bottom) {
+        if (iocs->dirtyTop > top) {
+            iocs->dirtyTop = top;
+        }
+        if (iocs->dirtyBottom < bottom) {
+            iocs->dirtyBottom = bottom;
+        }
+    }
+}
+void IocsMarkDirtyAll(void)
+{
+    IocsMarkDirty(0, LCD_ROWS);
+}
+
+// 更新行があるかどうかを判定する
+//
+bool IocsIsDirty(void)
+{
+    return iocs != NULL && iocs->dirtyTop < iocs->dirtyBottom ? true : false;
+}
+
+// パネルを設定する
+//
+void IocsSetPanel(int order, int x, int y, int width, int height, bool opaque)
+{
+    if (iocs != NULL && order >= 0 && order < kIocsPanelSize) {
+        iocs->panels[order].x = x;
+        iocs->panels[order].y = y;
+        iocs->panels[order].width = width;
+        iocs->panels[order].height = height;
+        iocs->panels[order].opaque = opaque;
+    }
+}
+void IocsResetPanel(int order)
+{
+    IocsSetPanel(order, 0, 0, 0, 0, false);
+}
+
+// 指定の描画順より手前の不透明なパネルで行の帯が覆われるかどうかを判定する
+//
+static bool IocsIsBandCovered(int order, int top, int bottom, int left, int right)
+{
+    // 左端から覆われている範囲を右へ伸ばしていく
+    int x = left;
+    bool extended = true;
+    while (x < right && extended) {
+        extended = false;
+        for (int i = order + 1; i < kIocsPanelSize; i++) {
+            struct IocsPanel *panel = &iocs->panels[i];
+            if (
+                panel->opaque && panel->width > 0 && 
+                panel->y <= top && panel->y + panel->height >= bottom && 
+                panel->x <= x && panel->x + panel->width > x
+            ) {
+                x = panel->x + panel->width;
+                extended = true;
+            }
+        }
+    }
+    return x >= right ? true : false;
+}
+
+// 矩形のうち更新行にあって手前のパネルに覆われない行の範囲を取得する
+//
+int IocsGetVisibleRows(int order, int x, int y, int width, int height, int *tops, int *bottoms, int size)
+{
+    if (iocs == NULL) {
+        return 0;
+    }
+
+    // 更新行と画面で矩形を切り取る
+    int top = y > iocs->dirtyTop ? y : iocs->dirtyTop;
+    int bottom = y + height < iocs->dirtyBottom ? y + height : iocs->dirtyBottom;
+    int left = x > 0 ? x : 0;
+    int right = x + width < LCD_COLUMNS ? x + width : LCD_COLUMNS;
+    if (top >= bottom || left >= right) {
+        return 0;
+    }
+
+    // 手前のパネルの上下端で行を帯に分ける
+    int edges[kIocsPanelSpanSize + 1];
+    int edge = 0;
+    edges[edge++] = top;
+    edges[edge++] = bottom;
+    for (int i = order + 1; i < kIocsPanelSize; i++) {
+        struct IocsPanel *panel = &iocs->panels[i];
+        if (panel->opaque && panel->width > 0) {
+            if (panel->y > top && panel->y < bottom) {
+                edges[edge++] = panel->y;
+            }
+            if (panel->y + panel->height > top && panel->y + panel->height < bottom) {
+                edges[edge++] = panel->y + panel->height;
+            }
+        }
+    }
+    for (int i = 1; i < edge; i++) {
+        int value = edges[i];
+        int j = i;
+        while (j > 0 && edges[j - 1] > value) {
+            edges[j] = edges[j - 1];
+            --j;
+        }
+        edges[j] = value;
+    }
+
+    // 覆われていない帯をつなげる
+    int count = 0;
+    for (int i = 0; i + 1 < edge; i++) {
+        if (edges[i] < edges[i + 1] && !IocsIsBandCovered(order, edges[i], edges[i + 1], left, right)) {
+            if (count > 0 && bottoms[count - 1] == edges[i]) {
+                bottoms[count - 1] = edges[i + 1];
+            } else if (count < size) {
+                tops[count] = edges[i];
+                bottoms[count] = edges[i + 1];
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+// パネルのビットマップを見える行にだけ描画する
+//
+void IocsDrawPanelBitmap(int order, LCDBitmap *bitmap, int x, int y)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL || order < 0 || order >= kIocsPanelSize) {
+        return;
+    }
+
+    // 見える行の取得
+    struct IocsPanel *panel = &iocs->panels[order];
+    int tops[kIocsPanelSpanSize];
+    int bottoms[kIocsPanelSpanSize];
+    int count = IocsGetVisibleRows(order, panel->x, panel->y, panel->width, panel->height, tops, bottoms, kIocsPanelSpanSize);
+
+    // ビットマップの描画
+    playdate->graphics->setDrawMode(kDrawModeCopy);
+    for (int i = 0; i < count; i++) {
+        playdate->graphics->setClipRect(panel->x, tops[i], panel->width, bottoms[i] - tops[i]);
+        playdate->graphics->drawBitmap(bitmap, x, y, kBitmapUnflipped);
+    }
+    IocsClipDirty();
+}
+
+// 更新行を反映する
+//
+void IocsFlushDirty(void)
+{
+    // Playdate の取得
+    PlaydateAPI *playdate = IocsGetPlaydate();
+    if (playdate == NULL) {
+        return;
+    }
+
+    // 更新行の反映
+    playdate->graphics->clearClipRect();
+    if (iocs->dirtyTop < iocs->dirtyBottom) {
+        playdate->graphics->markUpdatedRows(iocs->dirtyTop, iocs->dirtyBottom - 1);
     }
+    iocs->dirtyTop = LCD_ROWS;
+    iocs->dirtyBottom = 0;
 }
 
 // ボタンを初期化する
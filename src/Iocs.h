@@ -13,6 +13,23 @@
 enum {
     kIocsFrameRate = 30, 
     kIocsFrameMillisecond = 1000 / kIocsFrameRate, 
+    kIocsFrameRateBoost = 50, 
+    kIocsFrameBoostMillisecond = 500, 
+    kIocsFrameLowPowerPercentage = 20, 
+};
+
+// パネル
+//
+enum {
+    kIocsPanelSize = 8, 
+    kIocsPanelSpanSize = 2 * kIocsPanelSize + 1, 
+};
+struct IocsPanel {
+    int x;
+    int y;
+    int width;
+    int height;
+    bool opaque;
 };
 
 // フォント
@@ -24,6 +41,9 @@ typedef enum {
     kIocsFontMini, 
     kIocsFontSize, 
 } IocsFont;
+enum {
+    kIocsGlyphSize = 128, 
+};
 
 // ボタン
 //
@@ -60,10 +80,31 @@ struct Iocs {
 
     // フォント
     LCDFont *fonts[kIocsFontSize];
+    int fontHeights[kIocsFontSize];
+
+    // グリフ（ASCII のみ）
+    LCDBitmap *glyphBitmaps[kIocsFontSize][kIocsGlyphSize];
+    int8_t glyphAdvances[kIocsFontSize][kIocsGlyphSize];
+    bool glyphCached[kIocsFontSize][kIocsGlyphSize];
 
     // 画面
     LCDColor screenColor;
 
+    // フレームの経過時間（秒）
+    float frameDelta;
+
+    // フレームレートの調整（タイプライタやクランクの間だけ上げる）
+    int frameRate;
+    float frameBoost;
+    bool lowPower;
+
+    // 更新行
+    int dirtyTop;
+    int dirtyBottom;
+
+    // パネル（描画順ごとの矩形）
+    struct IocsPanel panels[kIocsPanelSize];
+
     // ボタン
     PDButtons buttonPush;
     PDButtons buttonEdge;
@@ -98,11 +139,22 @@ extern void IocsUpdateBegin(void);
 extern void IocsUpdateEnd(void);
 extern int IocsGetFrameRate(void);
 extern int IocsGetFrameMillisecond(void);
+extern float IocsGetFrameDelta(void);
+extern void IocsBoostFrameRate(void);
 extern void IocsSetFont(IocsFont font);
 extern int IocsGetFontHeight(IocsFont font);
 extern int IocsGetTextWidth(IocsFont font, const char *text);
+extern bool IocsGetGlyph(IocsFont font, char c, LCDBitmap **bitmap, int *advance);
 extern void IocsSetScreenColor(LCDColor color);
 extern void IocsClearScreen(void);
+extern void IocsMarkDirty(int y, int height);
+extern void IocsMarkDirtyAll(void);
+extern bool IocsIsDirty(void);
+extern void IocsFlushDirty(void);
+extern void IocsSetPanel(int order, int x, int y, int width, int height, bool opaque);
+extern void IocsResetPanel(int order);
+extern int IocsGetVisibleRows(int order, int x, int y, int width, int height, int *tops, int *bottoms, int size);
+extern void IocsDrawPanelBitmap(int order, LCDBitmap *bitmap, int x, int y);
 extern bool IocsIsButtonPush(PDButtons button);
 extern bool IocsIsButtonEdge(PDButtons button);
 extern bool IocsIsButtonRepeat(PDButtons button);
@@ -60,11 +60,18 @@ void ReportLoad(void)
         // タグの設定
         ActorSetTag(&report->actor, kGameTagReport);
 
+        // 更新行の設定
+        IocsMarkDirty(0, kReportBitmapSizeY);
+
+        // パネルの設定
+        IocsSetPanel(kGameOrderReport, LCD_COLUMNS - kReportBitmapSizeX, 0, kReportBitmapSizeX, kReportBitmapSizeY, true);
+
         // ビットマップの作成
         report->bitmap = playdate->graphics->newBitmap(kReportBitmapSizeX, kReportBitmapSizeY, kColorBlack);
         if (report->bitmap == NULL) {
             playdate->system->error("%s: %d: report bitmap is not created.", __FILE__, __LINE__);
         }
+        report->redraw = true;
     }
 }
 
@@ -78,6 +85,9 @@ static void ReportUnload(struct Report *report)
         return;
     }
 
+    // パネルの解除
+    IocsResetPanel(kGameOrderReport);
+
     // ビットマップの解放
     if (report->bitmap != NULL) {
         playdate->graphics->freeBitmap(report->bitmap);
@@ -94,12 +104,8 @@ static void ReportDraw(struct Report *report)
         return;
     }
 
-    // レポートの描画
-    GamePrintReport(report->bitmap);
-
     // ビットマップの描画
-    playdate->graphics->setDrawMode(kDrawModeCopy);
-    playdate->graphics->drawBitmap(report->bitmap, LCD_COLUMNS - kReportBitmapSizeX, 0, kBitmapUnflipped);
+    IocsDrawPanelBitmap(kGameOrderReport, report->bitmap, LCD_COLUMNS - kReportBitmapSizeX, 0);
 }
 
 // レポートが待機する
@@ -119,6 +125,12 @@ static void ReportLoop(struct Report *report)
         ++report->actor.state;
     }
 
+    // レポートの更新
+    if (GamePrintReport(report->bitmap, report->redraw)) {
+        IocsMarkDirty(0, kReportBitmapSizeY);
+    }
+    report->redraw = false;
+
     // 描画処理の設定
     ActorSetDraw(&report->actor, (ActorFunction)ReportDraw, kGameOrderReport);
 }
@@ -25,6 +25,7 @@ struct Report {
 
     // ビットマップ
     LCDBitmap *bitmap;
+    bool redraw;
 
 };
 
@@ -71,11 +71,20 @@ static int updateCallback(void *userdata)
 	// アクタの更新
 	ActorUpdate();
 
-	// 画面のクリア
-	IocsClearScreen();
+	// 更新行がある場合のみ描画する
+	int updated = 0;
+	if (IocsIsDirty()) {
 
-	// アクタの描画
-	ActorDraw();
+		// 画面のクリア
+		IocsClearScreen();
+
+		// アクタの描画
+		ActorDraw();
+
+		// 更新行の反映
+		IocsFlushDirty();
+		updated = 1;
+	}
 
 	// シーンの更新の完了
 	SceneUpdateEnd();
@@ -84,6 +93,6 @@ static int updateCallback(void *userdata)
 	IocsUpdateEnd();
 
 	// 終了
-	return 1;
+	return updated;
 }
 
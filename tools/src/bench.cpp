@@ -0,0 +1,650 @@
+// 参照ファイルのインクルード
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <chrono>
+#include "Basic.h"
+
+
+// 計測の回数
+//
+static const int kBenchCount = 10000000;
+
+// 計測が最適化で消えないようにする値
+//
+static volatile int benchSink = 0;
+
+// 経過時間を取得する（ナノ秒）
+//
+static double BenchNow(void)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// 行の処理（baseline の GamePlay にあった行番号の並び）
+//
+#define BENCH_LINES(X) \
+    X(  0) X(  5) X( 10) X( 40) X( 45) X( 50) X( 55) X( 60) X( 65) X( 70) \
+    X( 75) X( 80) X( 85) X( 90) X( 95) X(100) X(105) X(110) X(115) X(120) \
+    X(145) X(155) X(160) X(165) X(175) X(180) X(185) X(200) X(205) X(220) \
+    X(225) X(260) X(265) X(270) X(275) X(280) X(285) X(290) X(295) X(305) \
+    X(310) X(315) X(320) X(325) X(330) X(335) X(336) X(350) X(355) X(360) \
+    X(365) X(370) X(375) X(420) X(455) X(465) X(470) X(475) X(480) X(490) \
+    X(495) X(505) X(520) X(525) X(530) X(535) X(540) X(545) X(555) X(560) \
+    X(565) X(570) X(575) X(580) X(585) X(590) X(595) X(600) X(605) X(610) \
+    X(615)
+
+template <int N> __attribute__((noinline)) static void BenchLine(int *acc)
+{
+    *acc += N;
+}
+typedef void (*BenchFunction)(int *acc);
+
+// else if の連鎖で行を探す（変更前）
+//
+__attribute__((noinline)) static void BenchDispatchChain(int line, int *acc)
+{
+#define BENCH_CHAIN(n) if (line == n) { BenchLine<n>(acc); return; }
+    BENCH_LINES(BENCH_CHAIN)
+#undef BENCH_CHAIN
+}
+
+// 行番号で引く表で行を探す（変更後）
+//
+static BenchFunction benchFunctions[641];
+__attribute__((noinline)) static void BenchDispatchTable(int line, int *acc)
+{
+    BenchFunction function = line >= 0 && line < 641 ? benchFunctions[line] : NULL;
+    if (function != NULL) {
+        (*function)(acc);
+    }
+}
+
+// 行の呼び出しを計測する
+//
+static void BenchDispatch(void)
+{
+    // 表の作成
+#define BENCH_TABLE(n) benchFunctions[n] = BenchLine<n>;
+    BENCH_LINES(BENCH_TABLE)
+#undef BENCH_TABLE
+
+    // 先頭、中ほど、末尾の行で比べる
+    static const int lines[] = { 0, 120, 335, 555, 615, };
+    fprintf(stdout, "dispatch: ns per tick (chain / table)\n");
+    for (int i = 0; i < (int)(sizeof (lines) / sizeof (int)); i++) {
+        volatile int line = lines[i];
+        int acc = 0;
+        double t0 = BenchNow();
+        for (int j = 0; j < kBenchCount; j++) {
+            BenchDispatchChain(line, &acc);
+        }
+        double t1 = BenchNow();
+        for (int j = 0; j < kBenchCount; j++) {
+            BenchDispatchTable(line, &acc);
+        }
+        double t2 = BenchNow();
+        benchSink += acc;
+        fprintf(stdout, "  line %3d: %6.2f / %6.2f\n", lines[i], (t1 - t0) / kBenchCount, (t2 - t1) / kBenchCount);
+    }
+}
+
+
+// 計測用の乱数（GameRandom と同じく乗算とシフトで範囲に収める）
+//
+static uint32_t benchRandom = 2463534242u;
+static int BenchRandom(int n)
+{
+    benchRandom ^= benchRandom << 13;
+    benchRandom ^= benchRandom >> 17;
+    benchRandom ^= benchRandom << 5;
+    return (int)(((uint64_t)benchRandom * (uint32_t)n) >> 32) + 1;
+}
+
+// セクタ（@(71..134) と同じ 1..8 x 1..8、0=空 1=K 2=B 3=* 4=E）
+//
+enum {
+    kBenchSectorCount = 256, 
+};
+static int8_t benchSectorCells[kBenchSectorCount][64];
+static uint64_t benchSectorBits[kBenchSectorCount][5];
+static int benchSectorX[kBenchSectorCount];
+static int benchSectorY[kBenchSectorCount];
+static uint64_t benchSectorNeighbours[64];
+
+// 周囲の升目を 1 升ずつ見る（変更前の 145/150）
+//
+__attribute__((noinline)) static bool BenchDockLoop(int n)
+{
+    int x = benchSectorX[n];
+    int y = benchSectorY[n];
+    for (int i = x - (x > 1); i <= x + (x < 8); i++) {
+        for (int j = y - (y > 1); j <= y + (y < 8); j++) {
+            if (benchSectorCells[n][8 * (i - 1) + (j - 1)] == 2) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 近傍のマスクとの AND で見る（変更後の 145/150）
+//
+__attribute__((noinline)) static bool BenchDockMask(int n)
+{
+    int cell = 8 * (benchSectorX[n] - 1) + (benchSectorY[n] - 1);
+    return (benchSectorBits[n][2] & benchSectorNeighbours[cell]) != 0;
+}
+
+// 空いた升目を引き直しで探す（変更前の 165）
+//
+__attribute__((noinline)) static int BenchPlaceRetry(int n)
+{
+    while (true) {
+        int s = BenchRandom(8);
+        int t = BenchRandom(8);
+        int cell = 8 * (s - 1) + (t - 1);
+        if (benchSectorCells[n][cell] == 0) {
+            return cell;
+        }
+    }
+}
+
+// 空いた升目の n 番目を選ぶ（GameBasicSelectBit と同じ）
+//
+static int BenchSelectBit(uint64_t bits)
+{
+    int count = __builtin_popcountll(bits);
+    int select = BenchRandom(count) - 1;
+    int base = 0;
+    for (int c = __builtin_popcount((uint32_t)(bits & 0xff)); select >= c; c = __builtin_popcount((uint32_t)(bits & 0xff))) {
+        select -= c;
+        bits >>= 8;
+        base += 8;
+    }
+    while (select-- > 0) {
+        bits &= bits - 1;
+    }
+    return base + __builtin_ctzll(bits);
+}
+__attribute__((noinline)) static int BenchPlaceSelect(int n)
+{
+    return BenchSelectBit(~(benchSectorBits[n][1] | benchSectorBits[n][2] | benchSectorBits[n][3] | benchSectorBits[n][4]));
+}
+
+// ビットボードで 4 回まで引き直し、外れたら n 番目を選ぶ（変更後の 165）
+//
+__attribute__((noinline)) static int BenchPlaceHybrid(int n)
+{
+    uint64_t bits = ~(benchSectorBits[n][1] | benchSectorBits[n][2] | benchSectorBits[n][3] | benchSectorBits[n][4]);
+    for (int i = 0; i < 4; i++) {
+        int cell = BenchRandom(64) - 1;
+        if ((bits >> cell) & 1) {
+            return cell;
+        }
+    }
+    return BenchSelectBit(bits);
+}
+
+// セクタの処理を計測する
+//
+static void BenchSector(void)
+{
+    // 近傍の表の作成
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            uint64_t bits = 0;
+            for (int k = i - (i > 0); k <= i + (i < 7); k++) {
+                for (int l = j - (j > 0); l <= j + (j < 7); l++) {
+                    bits |= 1ull << (k * 8 + l);
+                }
+            }
+            benchSectorNeighbours[i * 8 + j] = bits;
+        }
+    }
+
+    // 50/55/60 と同じ密度のセクタを作る（E 1、K 0..3、B 0..1、* 1..8）
+    for (int n = 0; n < kBenchSectorCount; n++) {
+        memset(benchSectorCells[n], 0, sizeof (benchSectorCells[n]));
+        int counts[5] = { 0, BenchRandom(4) - 1, BenchRandom(2) - 1, BenchRandom(8), 1, };
+        for (int type = 4; type >= 1; type--) {
+            for (int i = 0; i < counts[type]; i++) {
+                int cell = BenchPlaceRetry(n);
+                benchSectorCells[n][cell] = type;
+                if (type == 4) {
+                    benchSectorX[n] = cell / 8 + 1;
+                    benchSectorY[n] = cell % 8 + 1;
+                }
+            }
+        }
+        for (int type = 0; type < 5; type++) {
+            benchSectorBits[n][type] = 0;
+        }
+        for (int cell = 0; cell < 64; cell++) {
+            benchSectorBits[n][benchSectorCells[n][cell]] |= 1ull << cell;
+        }
+    }
+
+    // 計測
+    double t[6];
+    int acc = 0;
+    t[0] = BenchNow();
+    for (int j = 0; j < kBenchCount; j++) {
+        acc += BenchDockLoop(j % kBenchSectorCount);
+    }
+    t[1] = BenchNow();
+    for (int j = 0; j < kBenchCount; j++) {
+        acc += BenchDockMask(j % kBenchSectorCount);
+    }
+    t[2] = BenchNow();
+    for (int j = 0; j < kBenchCount; j++) {
+        acc += BenchPlaceRetry(j % kBenchSectorCount);
+    }
+    t[3] = BenchNow();
+    for (int j = 0; j < kBenchCount; j++) {
+        acc += BenchPlaceSelect(j % kBenchSectorCount);
+    }
+    t[4] = BenchNow();
+    for (int j = 0; j < kBenchCount; j++) {
+        acc += BenchPlaceHybrid(j % kBenchSectorCount);
+    }
+    t[5] = BenchNow();
+    benchSink += acc;
+    fprintf(stdout, "sector: ns per call\n");
+    fprintf(stdout, "  dock : %6.2f (loop) / %6.2f (mask)\n", (t[1] - t[0]) / kBenchCount, (t[2] - t[1]) / kBenchCount);
+    fprintf(stdout, "  place: %6.2f (retry) / %6.2f (select) / %6.2f (bitboard retry + select)\n", (t[3] - t[2]) / kBenchCount, (t[4] - t[3]) / kBenchCount, (t[5] - t[4]) / kBenchCount);
+}
+
+
+// 計測に使う出力（420-450 のステータスレポート）
+//
+static const char *benchText = 
+    "STATUS REPORT:\n"
+    "STARDATE      3203\n"
+    "TIME LEFT       27\n"
+    "CONDITION     GREEN\n"
+    "POSITION      Q-45 S-27\n"
+    "ENERGY        3185\n"
+    "TORPEDOES        8\n"
+    "KLINGONS LEFT  14\n"
+    "STARBASES        3\n";
+
+// フォントの送り幅（ASCII）
+//
+static int benchGlyphAdvance[128];
+
+// 送り幅を作成する（美咲ゴシックの半角と同じく 4）
+//
+static void BenchLoadFont(void)
+{
+    for (int i = 0; i < 128; i++) {
+        benchGlyphAdvance[i] = i < 0x20 ? 0 : 4;
+    }
+}
+
+// UTF-8 の 1 文字のバイト数を取得する（IocsGetCharByte と同じ）
+//
+static int BenchGetCharByte(char c)
+{
+    return (c & 0x80) == 0x00 ? 1 : (c & 0xe0) == 0xc0 ? 2 : (c & 0xf0) == 0xe0 ? 3 : 2;
+}
+
+// 文字列の幅を測る（getTextWidth の代わり、SDK 内の処理は含まない）
+//
+__attribute__((noinline)) static int BenchGetTextWidth(const char *text, int length)
+{
+    int width = 0;
+    for (int i = 0; i < length; i += BenchGetCharByte(text[i])) {
+        width += benchGlyphAdvance[text[i] & 0x7f];
+    }
+    return width;
+}
+
+// 1 文字ずつ切り出して幅を測る（変更前）
+//
+__attribute__((noinline)) static int BenchGlyphMeasure(const char *text)
+{
+    int x = 0;
+    while (*text != '\0') {
+        char letter[8];
+        int length = BenchGetCharByte(*text);
+        strncpy(letter, text, length);
+        letter[length] = '\0';
+        text += length;
+        if (letter[0] != '\n') {
+            x += BenchGetTextWidth(letter, strlen(letter));
+        }
+    }
+    return x;
+}
+
+// キャッシュした送り幅を引く（変更後）
+//
+__attribute__((noinline)) static int BenchGlyphCache(const char *text)
+{
+    int x = 0;
+    for (; *text != '\0'; text++) {
+        unsigned char code = (unsigned char)*text;
+        if (code != '\n' && code < 128) {
+            x += benchGlyphAdvance[code];
+        }
+    }
+    return x;
+}
+
+// 1 文字ごとの処理を計測する
+//
+static void BenchGlyph(void)
+{
+    // 送り幅の作成
+    BenchLoadFont();
+
+    // 計測
+    int glyphs = (int)strlen(benchText);
+    int count = kBenchCount / glyphs;
+    int acc = 0;
+    const char *volatile text = benchText;
+    double t0 = BenchNow();
+    for (int j = 0; j < count; j++) {
+        acc += BenchGlyphMeasure(text);
+    }
+    double t1 = BenchNow();
+    for (int j = 0; j < count; j++) {
+        acc += BenchGlyphCache(text);
+    }
+    double t2 = BenchNow();
+    benchSink += acc;
+    fprintf(stdout, "glyph: glyphs per ms, layout only (measure / cache)\n");
+    fprintf(stdout, "  %.0f / %.0f\n", (double)count * glyphs * 1000000.0 / (t1 - t0), (double)count * glyphs * 1000000.0 / (t2 - t1));
+}
+
+
+// 整形済みの 1 文字（ConsoleGlyph と同じ）
+//
+enum {
+    kBenchGlyphNewLine = 0x01, 
+    kBenchGlyphBreak = 0x02, 
+    kBenchLineWidth = 400, 
+    kBenchQueueSize = 2048, 
+};
+struct BenchGlyph {
+    void *bitmap;
+    int16_t advance;
+    uint8_t length;
+    uint8_t flags;
+    char letter[4];
+};
+static struct BenchGlyph benchQueue[kBenchQueueSize];
+
+// 描画のたびに 1 文字ずつ切り出して幅を測り折り返す（変更前の ConsoleDraw）
+//
+__attribute__((noinline)) static int BenchTextDraw(const char *text)
+{
+    int x = 0;
+    int y = 0;
+    while (*text != '\0') {
+        char letter[8];
+        int length = BenchGetCharByte(*text);
+        strncpy(letter, text, length);
+        letter[length] = '\0';
+        text += length;
+        if (letter[0] == '\n') {
+            x = 0;
+            ++y;
+        } else {
+            int width = BenchGetTextWidth(letter, strlen(letter));
+            if (x + width > kBenchLineWidth) {
+                x = 0;
+                ++y;
+            }
+            x += width;
+        }
+    }
+    return x + y;
+}
+
+// 1 文字を整形する（ConsoleShapeGlyph と同じ）
+//
+static int BenchShapeGlyph(const char *text, struct BenchGlyph *glyph)
+{
+    int length = BenchGetCharByte(*text);
+    for (int i = 0; i < length; i++) {
+        glyph->letter[i] = text[i];
+    }
+    glyph->bitmap = NULL;
+    glyph->length = (uint8_t)length;
+    glyph->flags = 0;
+    glyph->advance = glyph->letter[0] != '\n' ? (int16_t)benchGlyphAdvance[glyph->letter[0] & 0x7f] : 0;
+    return length;
+}
+
+// 出力時に文字列をまとめて整形する（変更後の ConsolePrintText）
+//
+__attribute__((noinline)) static int BenchTextShape(const char *text)
+{
+    int count = 0;
+    int x = 0;
+    bool word = false;
+    while (*text != '\0') {
+        struct BenchGlyph glyph;
+        int length = BenchShapeGlyph(text, &glyph);
+        if (glyph.letter[0] == '\n') {
+            glyph.flags |= kBenchGlyphNewLine;
+            x = 0;
+            word = false;
+        } else if (glyph.letter[0] == ' ') {
+            word = false;
+        } else if (!word) {
+            int width = 0;
+            for (const char *next = text; *next != '\0' && *next != ' ' && *next != '\n'; ) {
+                struct BenchGlyph letter;
+                next += BenchShapeGlyph(next, &letter);
+                width += letter.advance;
+            }
+            if (x > 0 && x + width > kBenchLineWidth && width <= kBenchLineWidth) {
+                glyph.flags |= kBenchGlyphBreak;
+                x = 0;
+            }
+            word = true;
+        }
+        if ((glyph.flags & kBenchGlyphNewLine) == 0) {
+            if ((glyph.flags & kBenchGlyphBreak) == 0 && x + glyph.advance > kBenchLineWidth) {
+                glyph.flags |= kBenchGlyphBreak;
+                x = 0;
+            }
+            x += glyph.advance;
+        }
+        benchQueue[count++ % kBenchQueueSize] = glyph;
+        text += length;
+    }
+    return count;
+}
+
+// 整形済みの文字を描画位置へ送る（変更後の ConsoleDraw）
+//
+__attribute__((noinline)) static int BenchTextConsume(int count)
+{
+    int x = 0;
+    int y = 0;
+    for (int i = 0; i < count; i++) {
+        const struct BenchGlyph *glyph = &benchQueue[i % kBenchQueueSize];
+        if ((glyph->flags & (kBenchGlyphNewLine | kBenchGlyphBreak)) != 0) {
+            x = 0;
+            ++y;
+        }
+        x += glyph->advance;
+    }
+    return x + y;
+}
+
+// 文字列の出力を計測する
+//
+static void BenchText(void)
+{
+    // 送り幅の作成
+    BenchLoadFont();
+
+    // 185-195 の銀河図を作る
+    static char galaxy[1024];
+    int length = snprintf(galaxy, sizeof (galaxy), "ENTERPRISE IN Q-45 S-27 OF GALAXY MAP\n");
+    for (int i = 0; i < 8; i++) {
+        length += snprintf(&galaxy[length], sizeof (galaxy) - length, "\n%d:", i + 1);
+        for (int j = 0; j < 8; j++) {
+            length += snprintf(&galaxy[length], sizeof (galaxy) - length, "%4d", (i * 37 + j * 101) % 315);
+        }
+    }
+    length += snprintf(&galaxy[length], sizeof (galaxy) - length, "\n  ");
+    for (int i = 0; i < 8; i++) {
+        length += snprintf(&galaxy[length], sizeof (galaxy) - length, "  ..");
+    }
+    length += snprintf(&galaxy[length], sizeof (galaxy) - length, "\n  ");
+    for (int i = 0; i < 8; i++) {
+        length += snprintf(&galaxy[length], sizeof (galaxy) - length, "%4d", i + 1);
+    }
+    snprintf(&galaxy[length], sizeof (galaxy) - length, "\n\n");
+
+    // 計測
+    const char *names[] = { "status", "galaxy", };
+    const char *texts[] = { benchText, galaxy, };
+    fprintf(stdout, "text: ns per glyph (draw-time wrap / shape + consume = total)\n");
+    for (int i = 0; i < 2; i++) {
+        const char *volatile text = texts[i];
+        volatile int glyphs = (int)strlen(texts[i]);
+        int count = kBenchCount / glyphs;
+        int acc = 0;
+        double t0 = BenchNow();
+        for (int j = 0; j < count; j++) {
+            acc += BenchTextDraw(text);
+        }
+        double t1 = BenchNow();
+        for (int j = 0; j < count; j++) {
+            acc += BenchTextShape(text);
+        }
+        double t2 = BenchNow();
+        for (int j = 0; j < count; j++) {
+            acc += BenchTextConsume(glyphs);
+        }
+        double t3 = BenchNow();
+        benchSink += acc;
+        double n = (double)count * glyphs;
+        fprintf(stdout, "  %s: %6.2f / %6.2f + %6.2f = %6.2f\n", names[i], (t1 - t0) / n, (t2 - t1) / n, (t3 - t2) / n, (t3 - t1) / n);
+    }
+}
+
+
+// 計測に使う入力（IN. の順に、英字はその変数の値、数字はそのまま）
+//
+static const char *benchBasicInputs[] = {
+    "N", "R", "S", "L", "G", "W", "1", "90", "S", "P", "500", "T", "45", "R", "W", "2", "180", "S", "T", "270", "R", 
+};
+
+// 仮想機械の乱数
+//
+static int BenchBasicRandom(void *userdata, int n)
+{
+    (void)userdata;
+    return n < 1 ? 0 : BenchRandom(n) + 1;
+}
+
+// 入力を終えるまで仮想機械を回す（戻り値は BasicRun を呼んだ回数）
+//
+static int BenchBasicSession(const struct BasicProgram *program, int steps, int *length)
+{
+    static struct Basic basic;
+    static struct BasicMachine machine;
+    memset(&basic, 0, sizeof (basic));
+    benchRandom = 2463534242u;
+    BasicStart(&machine, program, &basic, BenchBasicRandom, NULL);
+    int count = (int)(sizeof (benchBasicInputs) / sizeof (benchBasicInputs[0]));
+    int input = 0;
+    int calls = 0;
+    while (input < count) {
+        int result = BasicRun(&machine, &basic, steps);
+        *length += machine.textLength;
+        ++calls;
+        if (result == kBasicResultInput) {
+            const char *a = benchBasicInputs[input++];
+            int value = a[0] >= 'A' && a[0] <= 'Z' ? BasicGetVariable(&basic, a[0] - 'A') : atoi(a);
+            BasicSetVariable(&basic, machine.input, value);
+            machine.input = -1;
+        } else if (result == kBasicResultStop || result == kBasicResultError) {
+            break;
+        }
+    }
+    return calls;
+}
+
+// 仮想機械を計測する
+//
+static void BenchBasic(void)
+{
+    // .bas の読み込み
+    static char source[16384];
+    FILE *file = fopen("res/basic/tinytrek.bas", "rb");
+    if (file == NULL) {
+        fprintf(stdout, "basic: res/basic/tinytrek.bas is not found\n");
+        return;
+    }
+    int length = (int)fread(source, 1, sizeof (source), file);
+    fclose(file);
+
+    // 翻訳
+    static struct BasicProgram program;
+    int count = 1000;
+    double t0 = BenchNow();
+    for (int i = 0; i < count; i++) {
+        if (!BasicCompile(&program, source, length)) {
+            fprintf(stdout, "basic: compile error %d at line %d\n", program.error, program.errorLine);
+            return;
+        }
+    }
+    double t1 = BenchNow();
+    fprintf(stdout, "basic: compile %d lines to %d codes: %8.2f us\n", program.lineSize, program.codeSize, (t1 - t0) / count / 1000.0);
+
+    // 1 命令ずつ回して命令の数を数える
+    int text = 0;
+    int codes = BenchBasicSession(&program, 1, &text);
+
+    // 1 フレームの上限（kGameBasicMachineStep）で回す
+    int sessions = 200;
+    int ticks = 0;
+    text = 0;
+    double t2 = BenchNow();
+    for (int i = 0; i < sessions; i++) {
+        ticks += BenchBasicSession(&program, 4096, &text);
+    }
+    double t3 = BenchNow();
+    benchSink += text;
+    fprintf(stdout, "basic: session of %d inputs: %d codes in %d ticks\n", (int)(sizeof (benchBasicInputs) / sizeof (benchBasicInputs[0])), codes, ticks / sessions);
+    fprintf(stdout, "  ns per code: %6.2f, us per tick: %8.2f, us per session: %8.2f\n", (t3 - t2) / ((double)codes * sessions), (t3 - t2) / ticks / 1000.0, (t3 - t2) / sessions / 1000.0);
+}
+
+
+// メインプログラムのエントリ
+//
+int main(void)
+{
+    // 処理の開始
+    fprintf(stdout, "bench ...\n");
+
+    // 行の呼び出し
+    BenchDispatch();
+
+    // セクタ
+    BenchSector();
+
+    // 文字
+    BenchGlyph();
+
+    // 文字列
+    BenchText();
+
+    // 仮想機械
+    BenchBasic();
+
+    // 終了
+    return 0;
+}